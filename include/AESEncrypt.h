@@ -0,0 +1,54 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_AESENCRYPT_H_
+#define INCLUDE_AESENCRYPT_H_
+
+#include "CipherEncrypt.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/*
+ * @brief AES-256 分组密码（FIPS 197），只实现加密方向，供 CTR 模式使用
+ * @description 运行时检测CPU：x86-64 支持 AES-NI 时每次并行加密8个计数器块，
+ *  AArch64 支持 ARMv8 AES 指令时同样8块并行，否则使用查表（T-table）实现，各实现结果完全相同
+*/
+class AES256 {
+ public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 16;
+    static constexpr int ROUNDS = 14;
+
+    // 由32字节密钥展开轮密钥
+    explicit AES256(const uint8_t* key);
+
+    // 加密一个16字节分组（查表实现）
+    void encryptBlock(const uint8_t* in, uint8_t* out) const;
+
+    // CTR 模式：data[i] ^= 密钥流，第 k 个分组的计数器块为 nonce(8字节) || 大端(counter + k)，
+    // data 对应的起始块号为 counter，加密与解密为同一操作
+    void ctrXor(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const;
+
+    // CTR 模式的查表实现
+    void ctrXorPortable(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const;
+
+    // 当前使用的实现名称："aesni"、"armv8-aes" 或 "table"
+    static const char* getImplementationName();
+
+ private:
+    std::array<uint32_t, 4 * (ROUNDS + 1)> roundKeys;  // 大端字，查表实现使用
+    alignas(16) std::array<uint8_t, BLOCK_SIZE * (ROUNDS + 1)> roundKeyBytes;  // 按字节排列，硬件指令使用
+};
+
+class AESEncrypt : public CipherEncrypt {
+ public:
+    EncryptType getEncryptType() const override { return EncryptType::AES; }
+    std::string getEncryptTypeName() const override { return "AES"; }
+
+ protected:
+    // AES-256-CTR 密钥流
+    std::unique_ptr<IKeystream> createKeystream(const uint8_t* key) const override;
+};
+
+#endif  // INCLUDE_AESENCRYPT_H_
@@ -34,6 +34,10 @@ class CBackup {
     bool doRecovery(const BackupEntry& entry, const std::string& destDir);
     // 重载：接收外部提供的密码（GUI 情况下传入），若传入空串则回退到控制台交互以保持 CLI 兼容
     bool doRecovery(const BackupEntry& entry, const std::string& destDir, const std::string& password);
+    // 重载：只恢复相对路径（以备份源的名字开头）与 paths 中任一模式匹配的文件或目录，paths 为空时恢复全部；
+    // 打包备份通过包的目录索引直接定位匹配的文件
+    bool doRecovery(const BackupEntry& entry, const std::string& destDir, const std::string& password,
+                    const std::vector<std::string>& paths);
 
 
  private:
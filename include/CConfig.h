@@ -14,6 +14,7 @@
 #include <stdexcept>
 
 #include "Utils.h"
+#include "ICompress.h"  // COMPRESS_DEFAULT_LEVEL
 /**
  * @brief 配置类，负责存储和管理备份系统的所有配置项
  * @details 涵盖源路径、目标路径、文件筛选、备份行为（打包/压缩/加密）等配置，提供完整的 setter/getter 接口
@@ -172,7 +173,7 @@ class CConfig {
     const std::string& getCompressionType() const;
     /**
      * 设置压缩级别（1-9，级别越高压缩率越高但速度越慢）
-     * @param level 压缩级别（1-9，默认1）
+     * @param level 压缩级别（1-9，默认 COMPRESS_DEFAULT_LEVEL）
      * @return 返回自身引用，支持链式调用
      * @throw std::invalid_argument 若级别超出1-9范围
      */
@@ -289,7 +290,7 @@ class CConfig {
     std::string m_packType = "tar";            // 打包类型（默认 tar）
     bool m_enableCompression = false;          // 是否启用压缩
     std::string m_compressionType = "gzip";    // 压缩类型（默认 gzip）
-    int m_compressionLevel = 1;                // 压缩级别（默认 1，1-9）
+    int m_compressionLevel = COMPRESS_DEFAULT_LEVEL;  // 压缩级别（1-9），与 CLI、GUI 和各压缩器的默认值一致
     bool m_enableEncryption = false;           // 是否启用加密
     std::string m_encryptionKey;               // 加密密钥
     std::string m_encryptType = "SimXOR";      // 加密类型（默认 SimXOR）
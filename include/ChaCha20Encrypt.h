@@ -0,0 +1,51 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_CHACHA20ENCRYPT_H_
+#define INCLUDE_CHACHA20ENCRYPT_H_
+
+#include "CipherEncrypt.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/*
+ * @brief ChaCha20 流密码（64位块计数 + 64位 nonce 的原始形式）
+ * @description 只用加法、异或和循环移位，没有查表，不依赖 AES 硬件指令。运行时检测CPU：
+ *  AVX2 每次并行生成8个密钥流块，SSE2 / NEON 每次4块，否则使用标量实现，各实现结果完全相同
+*/
+class ChaCha20 {
+ public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    // 由32字节密钥初始化
+    explicit ChaCha20(const uint8_t* key);
+
+    // data[i] ^= 密钥流，第 k 个密钥流块的块计数为 counter + k，nonce 为8字节
+    void xorKeystream(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const;
+
+    // 标量实现
+    void xorKeystreamPortable(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const;
+
+    // 当前使用的实现名称："avx2"、"sse2"、"neon" 或 "scalar"
+    static const char* getImplementationName();
+
+ private:
+    // 初始状态：常量、密钥、块计数（由实现按块填入）、nonce
+    std::array<uint32_t, 16> initialState(const uint8_t* nonce) const;
+
+    std::array<uint32_t, 8> keyWords;
+};
+
+class ChaCha20Encrypt : public CipherEncrypt {
+ public:
+    EncryptType getEncryptType() const override { return EncryptType::ChaCha20; }
+    std::string getEncryptTypeName() const override { return "ChaCha20"; }
+
+ protected:
+    // ChaCha20 密钥流
+    std::unique_ptr<IKeystream> createKeystream(const uint8_t* key) const override;
+};
+
+#endif  // INCLUDE_CHACHA20ENCRYPT_H_
@@ -0,0 +1,151 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_CIPHERENCRYPT_H_
+#define INCLUDE_CIPHERENCRYPT_H_
+
+#include "IEncrypt.h"
+#include "CRC32.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <string>
+
+#define CIPHER_FORMAT_VERSION 2  // 当前写入的加密文件格式版本（CipherFormat::Chunked）
+#define CIPHER_KEY_SIZE 32  // 派生密钥长度（256位）
+#define CIPHER_SALT_SIZE 16  // 密钥派生的盐长度
+#define CIPHER_NONCE_SIZE 8  // 计数器块的前8字节，后8字节为64位块计数
+#define CIPHER_KDF_ITERATIONS 100000  // PBKDF2 迭代次数
+#define CIPHER_MAX_KDF_ITERATIONS 10000000  // 解密时接受的最大迭代次数，防止损坏的头导致长时间计算
+#define CIPHER_BUFFER_SIZE (1 << 20)  // 加解密缓冲区大小 1MB
+#define CIPHER_CHUNK_SIZE (1 << 20)  // 分块格式每块明文大小 1MB
+#define CIPHER_MAX_CHUNK_SIZE (64 << 20)  // 解密时接受的最大分块大小
+#define CIPHER_TAG_SIZE 16  // 分块认证标签长度（Poly1305）
+
+// 加密文件格式版本
+enum class CipherFormat : uint16_t {
+    Stream = 1,  // 整个文件一条密钥流，只有明文CRC32校验
+    Chunked = 2,  // 分块格式：每块独立的 nonce 和认证标签，带分块索引，可以从任意偏移开始解密
+};
+
+// 流密码加密文件头：前两个字节与 EncHead 相同（加密标志、加密类型），便于 EncryptFactory 识别
+struct CipherEncHead {
+    uint8_t isEncrypt;  // 是否加密，0x31为加密，1字节
+    EncryptType encryptType;  // 加密算法类型
+    uint16_t version;  // 格式版本 CIPHER_FORMAT_VERSION
+    uint32_t headerSize;  // 头大小，其后为分块信息（Chunked）或密文（Stream）
+    uint32_t crc32;  // 明文的CRC32校验值
+    uint32_t iterations;  // PBKDF2 迭代次数
+    uint8_t salt[CIPHER_SALT_SIZE];  // 密钥派生的随机盐
+    uint8_t nonce[CIPHER_NONCE_SIZE];  // 随机 nonce
+};
+
+// 分块格式在 CipherEncHead 之后的分块信息，其后为 chunkCount 个 CipherChunkEntry 组成的索引，再之后为各块密文；
+// 除最后一块外每块明文都是 chunkSize 字节，第 i 块密文位于 索引结束位置 + i * chunkSize
+struct CipherChunkHead {
+    uint32_t chunkSize;  // 每块明文大小
+    uint32_t reserved;
+    uint64_t chunkCount;  // 分块数量
+    uint64_t originalSize;  // 明文总大小
+};
+
+// 分块索引项
+struct CipherChunkEntry {
+    uint8_t nonce[CIPHER_NONCE_SIZE];  // 本块的 nonce（文件 nonce 与块序号异或），本块密钥流从块号0开始
+    uint32_t size;  // 本块明文（即密文）大小
+    uint32_t reserved;
+    uint8_t tag[CIPHER_TAG_SIZE];  // 对密文、块序号、大小、是否最后一块的 Poly1305 认证标签
+};
+
+/*
+ * @brief 计数器模式的密钥流
+ * @description 第 k 个密钥流块由 nonce 与块号 counter + k 生成，可以从任意块号开始，加密与解密为同一操作
+*/
+class IKeystream {
+ public:
+    virtual ~IKeystream() = default;
+
+    // data[i] ^= 密钥流，data 对应的起始块号为 counter
+    virtual void apply(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const = 0;
+
+    // 密钥流块大小（字节），CIPHER_BUFFER_SIZE 必须是它的整数倍
+    virtual size_t blockSize() const = 0;
+};
+
+/*
+ * @brief 分块格式加密文件的随机读取器
+ * @description 由 CipherEncrypt::openReader 创建，密钥只在打开时派生一次；
+ *  每次读取只解密涉及的分块，并在解密前校验其认证标签
+*/
+class CipherReader {
+ public:
+    // 明文总大小
+    uint64_t size() const { return chunkHead.originalSize; }
+
+    // 读取明文 [offset, offset + size) 到 out，越界、读取失败或认证失败时返回false
+    bool read(uint64_t offset, uint8_t* out, size_t size);
+
+ private:
+    friend class CipherEncrypt;
+    CipherReader() = default;
+
+    // 读取、校验并解密第 index 块到 chunk
+    bool loadChunk(uint64_t index);
+
+    std::ifstream in;
+    std::string path;
+    std::unique_ptr<IKeystream> keystream;
+    CipherChunkHead chunkHead{};
+    std::vector<CipherChunkEntry> entries;
+    uint64_t dataOffset = 0;  // 第0块密文的文件偏移
+    uint64_t chunkIndex = UINT64_MAX;  // chunk 中缓存的是第几块
+    std::vector<uint8_t> chunk;
+};
+
+/*
+ * @brief 基于计数器模式流密码的加密器公共部分
+ * @description 由密码和随机盐经 PBKDF2-HMAC-SHA256 派生256位密钥，写入 CipherEncHead；
+ *  明文按 CIPHER_CHUNK_SIZE 分块，每块用派生类提供的密钥流加密并计算 Poly1305 认证标签，
+ *  解密时逐块先认证再解密，数据损坏或密码错误在出问题的分块处即可发现；
+ *  各块在线程池上并行处理并按偏移直接读写文件，整个文件的CRC32由各块的CRC按顺序合并得到
+*/
+class CipherEncrypt : public IEncrypt {
+ public:
+    // 加密文件
+    std::string encryptFile(const std::string& sourcePath, const std::string& key) override;
+
+    // 解密文件
+    bool decryptFile(const std::string& sourcePath, const std::string& destPath, const std::string& key) override;
+
+    // 打开分块格式的加密文件用于随机读取，失败时返回nullptr
+    std::unique_ptr<CipherReader> openReader(const std::string& sourcePath, const std::string& key) const;
+
+    // 设置/获取并行加密/解密的线程数，0 表示使用硬件并发数
+    void setThreadCount(size_t count) { threadCount = count; }
+    size_t getThreadCount() const { return threadCount; }
+
+ protected:
+    // 由派生出的 CIPHER_KEY_SIZE 字节密钥创建密钥流
+    virtual std::unique_ptr<IKeystream> createKeystream(const uint8_t* key) const = 0;
+
+ private:
+    // 读取并校验文件头，成功后 in 位于 CipherEncHead 之后
+    bool readHeader(std::ifstream& in, const std::string& sourcePath, CipherEncHead& head) const;
+
+    // 读取分块信息和索引，成功后 in 位于第0块密文处
+    static bool readChunkIndex(std::ifstream& in, const std::string& sourcePath, const CipherEncHead& head,
+                               CipherChunkHead& chunkHead, std::vector<CipherChunkEntry>& entries);
+
+    // 解密整个文件为一条密钥流的旧格式（CipherFormat::Stream）
+    bool decryptStream(std::ifstream& in, std::ofstream& out, const CipherEncHead& head, const std::string& key) const;
+
+    // 解密分块格式，in 位于分块信息处
+    bool decryptChunked(std::ifstream& in, const std::string& sourcePath, const std::string& destPath,
+                        const CipherEncHead& head, const std::string& key) const;
+
+    size_t threadCount = 0;
+};
+
+#endif  // INCLUDE_CIPHERENCRYPT_H_
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include "ICompress.h"  // 依赖ICompress抽象类
 #include "HuffmanCompress.h"
+#include "LZ77Compress.h"
+#include "FSECompress.h"
 
 // 压缩工厂类：负责责创建不同类型的压缩器实例
 class CompressFactory {
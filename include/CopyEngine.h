@@ -0,0 +1,74 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_COPYENGINE_H_
+#define INCLUDE_COPYENGINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#define COPY_BUFFER_SIZE (1 << 20)  // 用户态缓冲区复制时的缓冲区大小 1MB
+
+// 文件内容复制方式，按尝试顺序排列
+enum class CopyMethod : uint8_t {
+    Reflink = 0,  // FICLONE：与源文件共享数据块（XFS/btrfs 等），只修改元数据
+    CopyFileRange = 1,  // copy_file_range：在内核内复制，部分文件系统会转为克隆或服务端复制
+    Sendfile = 2,  // sendfile：在内核内复制，数据不经过用户态
+    Buffered = 3,  // 用户态缓冲区读写
+};
+
+/*
+ * @brief 文件内容复制引擎
+ * @description 打开一个目标文件，把若干源文件的内容复制到目标文件的指定偏移处；
+ *  依次尝试 FICLONE（仅限整个源文件复制到空目标文件）、copy_file_range、sendfile，最后回退到缓冲区读写；
+ *  某种方式在当前内核或文件系统上不可用时记下，之后的复制不再尝试。非 Linux 平台只使用缓冲区读写
+*/
+class CopyEngine {
+ public:
+    CopyEngine() = default;
+    ~CopyEngine();
+
+    CopyEngine(const CopyEngine&) = delete;
+    CopyEngine& operator=(const CopyEngine&) = delete;
+
+    // 打开目标文件（不存在时创建，存在时清空）
+    bool open(const std::filesystem::path& destPath);
+
+    // 在目标文件 offset 处写入一段数据（用于包头等由程序生成的内容）
+    bool write(uint64_t offset, const void* data, size_t size);
+
+    // 把源文件的前 size 字节复制到目标文件 offset 处，源文件不足 size 字节时返回false
+    bool copy(const std::filesystem::path& srcPath, uint64_t offset, uint64_t size);
+
+    // 关闭目标文件，写入出错时返回false
+    bool close();
+
+    // 最近一次 copy 最终使用的方式
+    CopyMethod getLastMethod() const { return lastMethod; }
+
+    // 复制方式名称
+    static const char* getMethodName(CopyMethod method);
+
+ private:
+    // 单种复制方式的结果
+    enum class CopyStatus : uint8_t {
+        Finished,  // 复制完成，或源文件提前结束（此时 done < size）
+        Unsupported,  // 该方式不适用于这对文件，由下一种方式从 done 处接着复制
+        Failed,  // 读写出错（errno 记录在 lastError 中），不再尝试其他方式
+    };
+
+    // 各方式从源文件的 done 字节处继续复制，done 随复制进度更新
+    CopyStatus copyFileRange(int srcFd, uint64_t offset, uint64_t size, uint64_t& done);
+    CopyStatus copySendfile(int srcFd, uint64_t offset, uint64_t size, uint64_t& done);
+    CopyStatus copyBuffered(int srcFd, uint64_t offset, uint64_t size, uint64_t& done);
+
+    int fd = -1;
+    bool empty = true;  // 目标文件打开后尚未写入任何内容
+    bool reflinkDisabled = false;
+    bool copyFileRangeDisabled = false;
+    bool sendfileDisabled = false;
+    CopyMethod lastMethod = CopyMethod::Buffered;
+    int lastError = 0;
+};
+
+#endif  // INCLUDE_COPYENGINE_H_
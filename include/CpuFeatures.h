@@ -0,0 +1,26 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_CPUFEATURES_H_
+#define INCLUDE_CPUFEATURES_H_
+
+/*
+ * @brief 运行时检测的CPU指令集特性
+ * @description 首次调用 get() 时检测一次，供 CRC32、加密等模块选择硬件加速实现；
+ *  AVX/AVX-512 同时要求操作系统已启用对应的寄存器状态保存（XGETBV）
+*/
+struct CpuFeatures {
+    // x86-64
+    bool sse41 = false;
+    bool pclmul = false;
+    bool aesni = false;
+    bool avx2 = false;
+    bool avx512 = false;  // AVX-512F
+    // AArch64
+    bool neon = false;
+    bool armCrc32 = false;
+    bool armAes = false;
+
+    // 获取当前CPU的特性
+    static const CpuFeatures& get();
+};
+
+#endif  // INCLUDE_CPUFEATURES_H_
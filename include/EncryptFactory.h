@@ -4,6 +4,8 @@
 
 #include "IEncrypt.h"
 #include "SimpleXOREncrypt.h"
+#include "AESEncrypt.h"
+#include "ChaCha20Encrypt.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -0,0 +1,86 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_FSECOMPRESS_H_
+#define INCLUDE_FSECOMPRESS_H_
+
+#include "ICompress.h"
+#include "CRC32.h"
+#include "MemoryStream.h"
+#include <array>
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <iostream>
+
+#define FSE_DEFAULT_BLOCK_SIZE (1 << 20)  // 默认块大小 1MB，每块独立统计并构建编码表
+#define FSE_MIN_TABLE_LOG 5  // 状态表最小为 2^5
+#define FSE_MAX_TABLE_LOG 12  // 状态表最大为 2^12，精度越高越接近信息熵
+#define FSE_RAW_BLOCK_FLAG 0x80000000u  // 块头中压缩大小的最高位：块按原样存储
+#define FSE_RLE_BLOCK_FLAG 0x40000000u  // 块头中压缩大小的次高位：块只有一种字节，块数据为该字节
+#define FSE_BLOCK_SIZE_MASK 0x3FFFFFFFu
+#define FSE_STORE_THRESHOLD 32  // 估算节省不到块大小的 1/32 时原样存储
+#define FSE_FORMAT_VERSION 0  // 当前写入的格式版本，解压时拒绝更高的版本
+
+// FSE压缩文件头，前两个字节与 Head 含义相同，便于工厂识别压缩类型
+struct FSEHead {
+    uint8_t isCompress;  // 是否压缩，0x21为压缩，1字节
+    CompressType compressType;  // 压缩算法类型，固定为FSE，1字节
+    uint8_t version;  // 格式版本，1字节
+    uint8_t level;  // 压缩级别（仅供参考，解压不依赖），1字节
+    uint32_t headerSize;  // 头大小，4字节
+    uint32_t blockSize;  // 块大小，4字节
+    uint64_t originalSize;  // 原始文件大小，8字节
+    uint32_t crc32;  // 原始数据CRC32校验值，4字节
+};
+
+// 每个块之前的块头
+struct FSEBlockHead {
+    uint32_t originalSize;  // 块原始大小
+    uint32_t compressedSize;  // 块数据大小，高两位为 FSE_RAW_BLOCK_FLAG / FSE_RLE_BLOCK_FLAG 标志
+};
+
+/*
+ * @brief 表驱动的非对称数字系统（tANS / FSE）熵编码压缩器
+ * @description 每个符号按其概率占用状态表中的若干个状态，编码时一个符号平均只输出其信息量那么多的位（可以是小数位），
+ *  压缩率比整数位码长的 Huffman 编码更接近信息熵。每个编码块的格式为：
+ *  1. 状态表位数（1字节）、最大符号（1字节）
+ *  2. 各符号的归一化计数（每个2字节，总和为状态表大小）
+ *  3. 位流：编码器倒序编码输入，解码器从位流末尾向前读，逐个状态查表得到符号和下一个状态
+*/
+class FSECompress : public ICompress {
+ public:
+    CompressType getCompressType() const override { return CompressType::FSE; }
+    std::string getCompressTypeName() const override { return "FSE"; }
+    // 压缩文件，返回压缩后的文件路径（源路径 + ".fse"）
+    std::string compressFile(const std::string& sourcePath) override;
+    bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    // 压缩/解压内存数据，格式与文件相同
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    // 压缩级别决定状态表位数：级别越高概率精度越高，压缩率越高，建表开销也越大
+    void setCompressionLevel(int level) override;
+    int getCompressionLevel() const override { return level; }
+
+    // 编码一个块（至少包含两种不同的字节），结果追加到 dst，返回编码后的大小；
+    // 估算编码后不能明显变小时不编码并返回0
+    static size_t compressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& dst,
+                                int maxTableLog = FSE_MAX_TABLE_LOG);
+    // 解码一个块到 dst（大小必须等于块原始大小），数据损坏时返回false
+    static bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize);
+
+ private:
+    int level = COMPRESS_DEFAULT_LEVEL;
+
+    // 压缩输入流写入输出流（输出流需支持 seekp，用于回写文件头）
+    bool compressStream(std::istream& in, std::ostream& out) const;
+    // 读取并校验文件头
+    static bool readHeader(std::istream& in, const std::string& sourceName, FSEHead& header);
+    // 逐块解压头之后的数据写入输出流并校验CRC
+    static bool decodeStream(std::istream& in, const std::string& sourceName, const FSEHead& header,
+                             std::ostream& out);
+    // 当前级别对应的最大状态表位数
+    int maxTableLog() const;
+};
+
+#endif  // INCLUDE_FSECOMPRESS_H_
@@ -4,6 +4,9 @@
 
 #include "ICompress.h"
 #include "CRC32.h"
+#include "HuffmanTable.h"
+#include "ThreadPool.h"
+#include "MemoryStream.h"
 #include <string>
 #include <filesystem>
 #include <fstream>
@@ -15,6 +18,14 @@
 #include <numeric>
 
 #define BUFF_SIZE 1 << 16  // 缓冲区大小 64KB
+#define HUFF_MAX_CODE_LEN 15  // 范式哈夫曼编码的最大长度，保证码长可以用4位存储
+#define HUFF_CODE_LENGTHS_SIZE 128  // 码长表大小，256个4位码长
+#define HUFF_DEFAULT_BLOCK_SIZE (1 << 20)  // 分块格式默认块大小 1MB
+#define HUFF_MIN_BLOCK_SIZE (1 << 16)  // 最小块大小 64KB
+#define HUFF_MAX_BLOCK_SIZE (1 << 26)  // 最大块大小 64MB
+#define HUFF_BLOCK_STORED 0x1u  // 块标志：原样存储（数据不可压缩）
+#define HUFF_STORE_THRESHOLD 32  // 编码后节省不到块大小的 1/32 时原样存储
+#define HUFF_JUMP_TABLE_SIZE ((HUFF_STREAM_COUNT - 1) * 4)  // 交错格式的跳转表：前3个位流的字节数
 
 
 struct HNode{
@@ -36,13 +47,91 @@ struct Head{
     uint8_t isCompress;  // 是否压缩，0x21为压缩，0x20为不压缩，1字节
     CompressType compressType;  // 压缩算法类型，固定为1字节
     uint8_t validBits;  // 最后一个字节的有效位，1字节
-    uint8_t reservedBits;  // 填充位，用于填充到字节边界，1字节
+    uint8_t version;  // 格式版本（原填充位，旧文件恒为0），见 HuffmanFormat，1字节
     uint32_t headerSize;  // 头大小， 4字节
-    uint32_t freqTableSize;   // 词频表大小，4字节
+    uint32_t freqTableSize;   // 词频表/块索引大小，4字节
     uint64_t originalSize;  // 原始文件大小, 8字节
     uint32_t crc32;  // CRC32校验值，4字节
 };  // 24字节
 
+// 压缩文件格式版本，记录在 Head::version 中
+enum class HuffmanFormat : uint8_t {
+    FreqTable = 0,  // 旧格式：头后为 (1字节符号 + 8字节词频) 的词频表，解压时重建哈夫曼树
+    Blocked = 1,  // 分块格式：头后为块索引，每块独立的码长表和CRC，编码数据分成4段独立位流，可并行压缩/解压
+};
+
+// 分块格式的块索引头，紧跟在 Head 之后，其后为 blockCount 个 HuffBlockEntry
+struct HuffBlockIndexHead {
+    uint32_t blockSize;  // 分块大小（最后一块可能更小），4字节
+    uint32_t blockCount;  // 块数量，4字节
+};  // 8字节
+
+// 块索引项，块数据为：码长表（128字节） + 跳转表（HUFF_JUMP_TABLE_SIZE字节） + 4个位流（各自按字节补齐）
+struct HuffBlockEntry {
+    uint64_t offset;  // 块数据在压缩文件中的偏移量，8字节
+    uint32_t originalSize;  // 块原始大小，4字节
+    uint32_t compressedSize;  // 块数据大小（含码长表），4字节
+    uint32_t crc32;  // 块原始数据的CRC32，4字节
+    uint32_t flags;  // 块标志（HUFF_BLOCK_STORED），4字节
+};  // 24字节
+
+// 解码方式
+enum class HuffmanDecodeMode : uint8_t {
+    Table = 0,  // 查表解码，一次解出多位（默认）
+    BitByBit = 1,  // 沿哈夫曼树逐位解码
+};
+
+// 解压失败（如CRC校验不通过）时对已写出的不完整文件的处理方式
+enum class CorruptOutputPolicy : uint8_t {
+    Delete = 0,  // 删除不完整的输出文件（默认）
+    Quarantine = 1,  // 重命名为 <目标路径>.corrupt 隔离保存，便于排查
+};
+
+// 解压输出缓冲区：固定大小，写满后落盘并累计CRC，内存占用与文件大小无关
+class HuffmanOutputBuffer {
+ public:
+    HuffmanOutputBuffer(std::ostream& out, size_t capacity) : out(out), buffer(capacity) {}
+
+    void put(uint8_t byte) {
+        if (pos == buffer.size()) flush();
+        buffer[pos++] = byte;
+    }
+
+    // 将缓冲区内容写入文件，同时更新CRC
+    bool flush() {
+        crc = CRC32::update(crc, buffer.data(), pos);
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(pos));
+        pos = 0;
+        return static_cast<bool>(out);
+    }
+
+    // 直接写出一段数据（先落盘缓冲区中已有的内容）
+    bool write(const uint8_t* data, size_t size) {
+        if (!flush()) return false;
+        crc = CRC32::update(crc, data, size);
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(out);
+    }
+
+    // 直接写出一段CRC32已知的数据（如已校验过的解压块），CRC由合并得到，不再重新计算
+    bool write(const uint8_t* data, size_t size, uint32_t dataCRC) {
+        if (!flush()) return false;
+        // crc 为未取反的中间值，合并前后各取反一次
+        crc = CRC32::finalize(CRC32::combine(CRC32::finalize(crc), dataCRC, size));
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(out);
+    }
+
+    // 获取已输出数据的CRC32（需先flush）
+    uint32_t getCRC() const { return CRC32::finalize(crc); }
+
+ private:
+    std::ostream& out;
+    std::vector<uint8_t> buffer;
+    size_t pos = 0;
+    uint32_t crc = CRC32::getInitialValue();
+};
+
 class HuffmanCompress : public ICompress {
  public:
     CompressType getCompressType() const override { return CompressType::Huffman; }
@@ -50,11 +139,73 @@ class HuffmanCompress : public ICompress {
     // 直接原地覆盖压缩，返回压缩后的文件路径
     std::string compressFile(const std::string& sourcePath) override;
     bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    // 压缩/解压内存数据，格式与文件相同
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    // 压缩级别只决定分块大小：低级别用小块（并行粒度细、内存占用小），高级别用大块（码长表开销更小）
+    void setCompressionLevel(int level) override;
+    int getCompressionLevel() const override { return level; }
+
+    // 设置/获取解码方式
+    void setDecodeMode(HuffmanDecodeMode mode) { decodeMode = mode; }
+    HuffmanDecodeMode getDecodeMode() const { return decodeMode; }
+
+    // 设置/获取解压失败时不完整输出文件的处理方式
+    void setCorruptOutputPolicy(CorruptOutputPolicy policy) { corruptPolicy = policy; }
+    CorruptOutputPolicy getCorruptOutputPolicy() const { return corruptPolicy; }
+
+    // 设置/获取分块大小，限制在 HUFF_MIN_BLOCK_SIZE ~ HUFF_MAX_BLOCK_SIZE 之间，会覆盖压缩级别选择的块大小
+    void setBlockSize(size_t size);
+    size_t getBlockSize() const { return blockSize; }
+
+    // 设置/获取并行压缩/解压的线程数，0 表示使用硬件并发数
+    void setThreadCount(size_t count) { threadCount = count; }
+    size_t getThreadCount() const { return threadCount; }
+
+    // 压缩后的数据块
+    struct EncodedBlock {
+        std::vector<uint8_t> data;  // 码长表 + 编码数据，原样存储时为原始数据
+        uint32_t crc32;
+        bool stored = false;
+    };
+
+    // 编码一个数据块（独立统计词频、生成码表，编码为4个交错位流），也供其他压缩器作为熵编码阶段使用；
+    // 由词频算出的编码大小表明数据不可压缩时不编码，原样存储
+    static EncodedBlock encodeBlock(const std::vector<uint8_t>& input);
+    // 解码一个数据块并校验CRC（entry 中只使用原始大小、CRC32和标志），失败时返回false
+    static bool decodeBlock(const std::vector<uint8_t>& block, const HuffBlockEntry& entry,
+                            HuffmanDecodeMode mode, std::vector<uint8_t>& output);
 
  private:
-    //  统计字节形成的字符串词频（固定256个）
-    static bool readFreqTable(const std::string& sourcePath, std::array<uint64_t, 256>& freqTable,
-        uint64_t& originalSize);
+    int level = COMPRESS_DEFAULT_LEVEL;
+    HuffmanDecodeMode decodeMode = HuffmanDecodeMode::Table;
+    CorruptOutputPolicy corruptPolicy = CorruptOutputPolicy::Delete;
+    size_t blockSize = HUFF_DEFAULT_BLOCK_SIZE;
+    size_t threadCount = 0;
+
+    // 分块压缩：源数据按块并行编码后按顺序写入（输出流需支持 seekp，用于回写文件头和块索引）
+    bool compressBlocks(std::istream& in, uint64_t originalSize, std::ostream& out) const;
+    // 读取并校验文件头和码表（旧格式会同时构造哈夫曼树，由调用方释放）
+    bool readHeader(std::istream& in, const std::string& sourceName, Head& header,
+                    std::array<std::vector<bool>, 256>& codes, HNode*& root) const;
+    // 解码头之后的数据写入输出流并校验CRC
+    bool decodeStream(std::istream& in, const std::string& sourceName, const Head& header,
+                      const std::array<std::vector<bool>, 256>& codes, HNode* root, std::ostream& out) const;
+    // 分块解压：按块并行解码后按顺序写出
+    bool decompressBlocks(std::istream& in, const Head& header, HuffmanOutputBuffer& output) const;
+    // 各位流的符号数：前3个位流各 ceil(size / 4) 个（不超过剩余数量），最后一个位流为剩余部分
+    static std::array<size_t, HUFF_STREAM_COUNT> streamCounts(size_t size);
+    // 在一段位流上沿哈夫曼树逐位解出 count 个字节，数据不足或损坏时返回false
+    static bool decodeTreeBits(HNode* root, const uint8_t* data, size_t size, uint8_t* dst, size_t count);
+    // 逐位解码：沿哈夫曼树逐位走，解出 originalSize 个字节
+    static bool decodeBitByBit(std::istream& in, HNode* root, const Head& header,
+                               HuffmanOutputBuffer& output);
+    // 打包/解包码长表
+    static void packCodeLengths(const std::array<uint8_t, 256>& codeLengths, uint8_t* packed);
+    static void unpackCodeLengths(const uint8_t* packed, std::array<uint8_t, 256>& codeLengths);
+    // 按策略处理解压失败留下的不完整输出文件
+    void discardOutput(std::ofstream& out, const std::string& destPath) const;
     // 构造哈夫曼树
     static HNode* buildHuffmanTree(const std::array<uint64_t, 256>& freqTable);
     // 生成哈夫曼编码(递归构造)
@@ -62,6 +213,13 @@ class HuffmanCompress : public ICompress {
                                     std::array<std::vector<bool>, 256>& codes);
     // 生成哈夫曼编码表
     static std::array<std::vector<bool>, 256> generateHuffmanCodes(HNode* root);
+    // 由词频计算各符号码长，超过 HUFF_MAX_CODE_LEN 的编码会被限长
+    static std::array<uint8_t, 256> buildCodeLengths(const std::array<uint64_t, 256>& freqTable);
+    // 由码长生成范式哈夫曼编码，码长不合法时返回false
+    static bool generateCanonicalCodes(const std::array<uint8_t, 256>& codeLengths,
+                                       std::array<std::vector<bool>, 256>& codes);
+    // 由编码表构造哈夫曼树（供逐位解码使用）
+    static HNode* buildTreeFromCodes(const std::array<std::vector<bool>, 256>& codes);
     // 删除树
     static void deleteHuffmanTree(HNode* node){
         if (!node) return;
@@ -0,0 +1,293 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_HUFFMANTABLE_H_
+#define INCLUDE_HUFFMANTABLE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+#define HUFF_TABLE_BITS 11  // 一级查表位数，一次查表最多解出11位的编码
+#define HUFF_STREAM_COUNT 4  // 交错格式中每块的位流数量
+
+/*
+ * @brief 哈夫曼编码位读取器
+ * @description 按字节内从高位到低位的顺序读取编码数据，数据来源可以是：
+ *  1. 一段内存（如分块格式中的一个数据块）
+ *  2. 输入流（内部使用固定大小的缓冲区分段读取）
+*/
+class HuffmanBitReader {
+ public:
+    HuffmanBitReader(const uint8_t* data, size_t size) : cur(data), end(data + size) {}
+    explicit HuffmanBitReader(std::istream& in) : in(&in), streamBuffer(1 << 16) {}
+
+    // 补充位缓冲区，尽量填满
+    void refill() {
+        // 剩余数据足够时一次装入8字节
+        if (end - cur >= 8) {
+            bitBuf |= loadBE64(cur) >> bitCount;
+            int bytes = (64 - bitCount) >> 3;
+            cur += bytes;
+            bitCount += bytes * 8;
+            return;
+        }
+        while (bitCount <= 56) {
+            if (cur == end && !fetch()) return;
+            bitBuf |= static_cast<uint64_t>(*cur++) << (56 - bitCount);
+            bitCount += 8;
+        }
+    }
+
+    // 查看接下来的 bits 位（不足时低位补0）
+    uint32_t peek(int bits) const { return static_cast<uint32_t>(bitBuf >> (64 - bits)); }
+
+    // 丢弃 bits 位
+    void consume(int bits) {
+        bitBuf <<= bits;
+        bitCount -= bits;
+    }
+
+    // 位缓冲区中的有效位数
+    int available() const { return bitCount; }
+
+    // 内存中剩余的数据是否还够一次装入8字节（此时 refill 后至少有57位）
+    bool canRefillFast() const { return end - cur >= 8; }
+
+ private:
+    // 从输入流读取下一段数据
+    bool fetch() {
+        if (!in) return false;
+        in->read(reinterpret_cast<char*>(streamBuffer.data()), static_cast<std::streamsize>(streamBuffer.size()));
+        std::streamsize n = in->gcount();
+        if (n <= 0) return false;
+        cur = streamBuffer.data();
+        end = cur + n;
+        return true;
+    }
+
+    // 按大端序读取8字节
+    static uint64_t loadBE64(const uint8_t* p) {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) {
+            v = (v << 8) | p[i];
+        }
+        return v;
+    }
+
+    std::istream* in = nullptr;
+    std::vector<uint8_t> streamBuffer;
+    const uint8_t* cur = nullptr;
+    const uint8_t* end = nullptr;
+    uint64_t bitBuf = 0;  // 左对齐，最高位为下一个待读取的位
+    int bitCount = 0;
+};
+
+/*
+ * @brief 哈夫曼编码位写入器
+ * @description 按字节内从高位到低位的顺序写入编码（与 HuffmanBitReader 对应），
+ *  编码先累积在64位缓冲区中，满32位时整字写出；调用方需保证目标缓冲区足够大
+*/
+class HuffmanBitWriter {
+ public:
+    explicit HuffmanBitWriter(uint8_t* dst) : begin(dst), cur(dst) {}
+
+    // 写入 len 位编码（len 不超过32，编码在 code 的低位）
+    void write(uint32_t code, int len) {
+        bitBuf |= static_cast<uint64_t>(code) << (64 - bitCount - len);
+        bitCount += len;
+        if (bitCount >= 32) {
+            uint32_t word = static_cast<uint32_t>(bitBuf >> 32);
+            cur[0] = static_cast<uint8_t>(word >> 24);
+            cur[1] = static_cast<uint8_t>(word >> 16);
+            cur[2] = static_cast<uint8_t>(word >> 8);
+            cur[3] = static_cast<uint8_t>(word);
+            cur += 4;
+            bitBuf <<= 32;
+            bitCount -= 32;
+        }
+    }
+
+    // 写出缓冲区中剩余的位（最后一个字节低位补0），返回写入的总字节数
+    size_t finish() {
+        while (bitCount > 0) {
+            *cur++ = static_cast<uint8_t>(bitBuf >> 56);
+            bitBuf <<= 8;
+            bitCount = bitCount > 8 ? bitCount - 8 : 0;
+        }
+        bitBuf = 0;
+        return static_cast<size_t>(cur - begin);
+    }
+
+ private:
+    uint8_t* begin;
+    uint8_t* cur;
+    uint64_t bitBuf = 0;  // 左对齐，最高位为最先写入的位
+    int bitCount = 0;
+};
+
+/*
+ * @brief 哈夫曼编码表
+ * @description 每个符号的编码压缩为 {编码, 码长}，编码时一次写入整个编码，
+ *  供所有基于哈夫曼编码的压缩器共用
+*/
+class HuffmanEncodeTable {
+ public:
+    struct Code {
+        uint32_t code;  // 编码，低 len 位有效
+        uint8_t len;  // 码长，0 表示符号不出现
+    };
+
+    // 由每个符号的编码（按位从高到低排列）构建编码表，编码超过32位时返回false
+    bool build(const std::array<std::vector<bool>, 256>& codes);
+
+    const Code& operator[](uint8_t symbol) const { return table[symbol]; }
+
+    // 编码 size 个字节到 writer
+    void encode(const uint8_t* data, size_t size, HuffmanBitWriter& writer) const {
+        for (size_t i = 0; i < size; ++i) {
+            const Code& c = table[data[i]];
+            writer.write(c.code, c.len);
+        }
+    }
+
+ private:
+    std::array<Code, 256> table{};
+};
+
+/*
+ * @brief 哈夫曼查表解码器
+ * @description 用编码的前 HUFF_TABLE_BITS 位作为下标查一级表：
+ *  1. 编码长度不超过 HUFF_TABLE_BITS 的符号一次查表即可得到符号和编码长度
+ *  2. 更长的编码在表项中记录走完前 HUFF_TABLE_BITS 位后到达的节点，剩余位逐位在编码树上走完
+*/
+class HuffmanDecodeTable {
+ public:
+    // 表项类型
+    enum class EntryKind : uint8_t {
+        Invalid = 0,  // 不对应任何编码（数据损坏）
+        Symbol = 1,  // 直接得到符号
+        Long = 2,  // 长编码，需要继续在编码树上逐位解码
+    };
+
+    struct Entry {
+        uint16_t value;  // Symbol时为符号，Long时为编码树节点下标
+        uint8_t len;  // Symbol时为编码长度
+        EntryKind kind;
+    };
+
+    // 由每个符号的编码（按位从高到低排列）构建解码表，编码不是前缀码时返回false
+    bool build(const std::array<std::vector<bool>, 256>& codes);
+
+    const Entry& lookup(uint32_t index) const { return table[index]; }
+
+    // 解出一个符号，数据不足或损坏时返回false
+    bool decodeSymbol(HuffmanBitReader& reader, uint8_t& symbol) const {
+        if (reader.available() < HUFF_TABLE_BITS) reader.refill();
+
+        // 用前 HUFF_TABLE_BITS 位查表
+        const Entry& entry = table[reader.peek(HUFF_TABLE_BITS)];
+        if (entry.kind == EntryKind::Symbol) {
+            if (entry.len > reader.available()) return false;  // 数据不足
+            symbol = static_cast<uint8_t>(entry.value);
+            reader.consume(entry.len);
+            return true;
+        }
+        if (entry.kind == EntryKind::Invalid || reader.available() < HUFF_TABLE_BITS) return false;
+
+        // 长编码：跳过已查表的位，剩余位沿编码树逐位解码
+        reader.consume(HUFF_TABLE_BITS);
+        int32_t node = entry.value;
+        while (node > 0) {
+            if (reader.available() == 0) {
+                reader.refill();
+                if (reader.available() == 0) return false;
+            }
+            uint32_t bit = reader.peek(1);
+            reader.consume(1);
+            node = nodes[node].child[bit];
+        }
+        if (node == kNoChild) return false;
+        symbol = static_cast<uint8_t>(-node - 1);
+        return true;
+    }
+
+    // 解出 count 个符号，每个符号交给 sink(uint8_t)；数据不足或损坏时返回false
+    template <typename Sink>
+    bool decode(HuffmanBitReader& reader, uint64_t count, Sink&& sink) const {
+        for (uint64_t i = 0; i < count; ++i) {
+            uint8_t symbol;
+            if (!decodeSymbol(reader, symbol)) return false;
+            sink(symbol);
+        }
+        return true;
+    }
+
+    /*
+     * @brief 交错解码 HUFF_STREAM_COUNT 个互相独立的位流
+     * @description 第 k 个位流解出 counts[k] 个符号写到 dst[k]，要求 counts[0] >= counts[1] >= ...；
+     *  每轮依次从各位流解出一个符号，各位流的查表和移位互不依赖，CPU可以同时执行
+    */
+    bool decodeInterleaved(HuffmanBitReader* const* readers, uint8_t* const* dst, const size_t* counts) const {
+        // 所有位流都还有符号时四路同时推进；数据充足时每轮每个位流补充一次位缓冲区，
+        // 之后连续解出3个符号（最多45位）不再检查剩余位数。
+        // 位读取器复制到局部变量，避免写出字节时编译器认为位缓冲区可能被修改而反复读写内存
+        const size_t common = counts[HUFF_STREAM_COUNT - 1];
+        size_t i = 0;
+        {
+            HuffmanBitReader s0 = *readers[0], s1 = *readers[1], s2 = *readers[2], s3 = *readers[3];
+            uint8_t* d0 = dst[0];
+            uint8_t* d1 = dst[1];
+            uint8_t* d2 = dst[2];
+            uint8_t* d3 = dst[3];
+            auto step = [this](HuffmanBitReader& reader, uint8_t& symbol) {
+                const Entry& entry = table[reader.peek(HUFF_TABLE_BITS)];
+                if (entry.kind == EntryKind::Symbol) {
+                    symbol = static_cast<uint8_t>(entry.value);
+                    reader.consume(entry.len);
+                    return true;
+                }
+                return decodeSymbol(reader, symbol);
+            };
+            while (i + 3 <= common && s0.canRefillFast() && s1.canRefillFast() &&
+                   s2.canRefillFast() && s3.canRefillFast()) {
+                s0.refill();
+                s1.refill();
+                s2.refill();
+                s3.refill();
+                for (int j = 0; j < 3; ++j, ++i) {
+                    if (!step(s0, d0[i]) || !step(s1, d1[i]) || !step(s2, d2[i]) || !step(s3, d3[i])) return false;
+                }
+            }
+            *readers[0] = s0;
+            *readers[1] = s1;
+            *readers[2] = s2;
+            *readers[3] = s3;
+        }
+        for (; i < common; ++i) {
+            for (int k = 0; k < HUFF_STREAM_COUNT; ++k) {
+                if (!decodeSymbol(*readers[k], dst[k][i])) return false;
+            }
+        }
+        // 较长的位流解出剩余的符号
+        for (int k = 0; k < HUFF_STREAM_COUNT - 1; ++k) {
+            for (size_t i = common; i < counts[k]; ++i) {
+                if (!decodeSymbol(*readers[k], dst[k][i])) return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr int32_t kNoChild = 0;
+
+ private:
+    // 编码树节点，子节点取值：0 表示不存在，大于0为节点下标，小于0为叶子 -(符号 + 1)
+    struct Node {
+        int32_t child[2];
+    };
+
+    std::array<Entry, 1u << HUFF_TABLE_BITS> table{};
+    std::vector<Node> nodes;
+};
+
+#endif  // INCLUDE_HUFFMANTABLE_H_
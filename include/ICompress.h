@@ -2,16 +2,31 @@
 #ifndef INCLUDE_ICOMPRESS_H_
 #define INCLUDE_ICOMPRESS_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 
+#define COMPRESS_MIN_LEVEL 1  // 最快
+#define COMPRESS_MAX_LEVEL 9  // 压缩率最高
+#define COMPRESS_DEFAULT_LEVEL 5
+#define COMPRESS_MAX_BLOCK_SIZE (4 << 20)  // 分块格式写入的最大块大小 4MB，解压时拒绝更大的块，避免按损坏的头分配内存
+#define COMPRESS_RESERVE_RATIO 8  // 内存解压时预留输出空间的上限（输入大小的倍数）
+
 enum class CompressType : uint8_t {
     None = 0,
     Huffman = 1,
     LZ77 = 2,
+    FSE = 3,
 };
 
+// 内存解压前为输出预留空间：头中的原始大小未经校验，不能直接按它分配，
+// 最多预留输入大小的 COMPRESS_RESERVE_RATIO 倍，实际更大时由解码过程扩容
+inline void reserveDecompressOutput(std::vector<char>& destData, uint64_t originalSize, size_t sourceSize) {
+    destData.reserve(static_cast<size_t>(
+        std::min<uint64_t>(originalSize, static_cast<uint64_t>(sourceSize) * COMPRESS_RESERVE_RATIO)));
+}
 
 // 压缩算法抽象接口
 class ICompress {
@@ -31,14 +46,17 @@ class ICompress {
     // 获取压缩算法名称
     virtual std::string getCompressTypeName() const = 0;
 
-    // // 压缩内存数据（源数据→目标数据）
-    // virtual bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
+    // 压缩内存数据（源数据→目标数据），结果与 compressFile 写出的文件内容相同
+    virtual bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
+
+    // 解压缩内存数据（源数据→目标数据）
+    virtual bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
 
-    // // 解压缩内存数据（源数据→目标数据）
-    // virtual bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
+    // 设置压缩级别（1-9，级别越高压缩率越高、速度越慢），超出范围时取最近的合法值
+    virtual void setCompressionLevel(int level) = 0;
 
-    // // 设置压缩级别（1-9，级别越高压缩率越高）
-    // virtual void setCompressionLevel(int level) = 0;
+    // 获取压缩级别
+    virtual int getCompressionLevel() const = 0;
 
     // // 获取压缩文件的扩展名（如"gz"、"zip"）
     // virtual std::string getFileExtension() const = 0;
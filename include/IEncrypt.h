@@ -13,6 +13,7 @@ enum class EncryptType : uint8_t{
     SimXOR = 1,
     AES = 2,
     DES = 3,
+    ChaCha20 = 4,
 };
 
 
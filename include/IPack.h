@@ -25,6 +25,10 @@ class IPack {
     // 解包：输入打包文件，输出解包目录
     virtual bool unpack(const std::string& srcPath, const std::string& destDir) = 0;
 
+    // 选择性解包：只解包相对路径与 patterns 中任一模式匹配的文件或目录，没有匹配项时返回false
+    virtual bool unpack(const std::string& srcPath, const std::string& destDir,
+                        const std::vector<std::string>& patterns) = 0;
+
     // 获取打包器类型
     virtual PackType getPackType() const = 0;
 
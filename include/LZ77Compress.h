@@ -0,0 +1,103 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_LZ77COMPRESS_H_
+#define INCLUDE_LZ77COMPRESS_H_
+
+#include "ICompress.h"
+#include "CRC32.h"
+#include "HuffmanCompress.h"
+#include "MemoryStream.h"
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <iostream>
+
+#define LZ_DEFAULT_BLOCK_SIZE (1 << 20)  // 默认块大小 1MB，块之间互不引用
+#define LZ_MIN_MATCH 4  // 最短匹配长度
+#define LZ_MAX_OFFSET 65535  // 最大匹配距离（2字节偏移）
+#define LZ_HASH_LOG 16  // 哈希表大小 2^16 项
+#define LZ_CHAIN_SIZE (1 << 16)  // 哈希链表大小，覆盖整个匹配窗口
+#define LZ_MATCH_LIMIT 12  // 块末尾这么多字节内不再开始新的匹配
+#define LZ_RAW_BLOCK_FLAG 0x80000000u  // 块头中压缩大小的最高位：块按原样存储
+#define LZ_ENTROPY_BLOCK_FLAG 0x40000000u  // 块头中压缩大小的次高位：LZ输出又经过Huffman编码
+#define LZ_BLOCK_SIZE_MASK 0x3FFFFFFFu
+#define LZ_FORMAT_VERSION 0  // 当前写入的格式版本，解压时拒绝更高的版本
+
+// LZ77压缩文件头，前两个字节与 Head 含义相同，便于工厂识别压缩类型
+struct LZHead {
+    uint8_t isCompress;  // 是否压缩，0x21为压缩，1字节
+    CompressType compressType;  // 压缩算法类型，固定为LZ77，1字节
+    uint8_t version;  // 格式版本，1字节
+    uint8_t level;  // 压缩级别（仅供参考，解压不依赖），1字节
+    uint32_t headerSize;  // 头大小，4字节
+    uint32_t blockSize;  // 块大小，4字节
+    uint64_t originalSize;  // 原始文件大小，8字节
+    uint32_t crc32;  // 原始数据CRC32校验值，4字节
+};
+
+// 每个块之前的块头
+struct LZBlockHead {
+    uint32_t originalSize;  // 块原始大小
+    uint32_t compressedSize;  // 块数据大小，高两位为 LZ_RAW_BLOCK_FLAG / LZ_ENTROPY_BLOCK_FLAG 标志
+};
+
+// 经过熵编码的块，块数据以此开头，后跟 Huffman 编码块（码长表 + 跳转表 + 4个交错位流）
+struct LZEntropyHead {
+    uint32_t lzSize;  // LZ输出大小
+    uint32_t crc32;  // LZ输出的CRC32
+};
+
+// 压缩级别对应的参数
+struct LZLevelParams {
+    int searchDepth;  // 每个位置最多比较的候选匹配数，1 时只查哈希表不维护哈希链
+    int skipShift;  // 连续未命中时按 (距上次匹配的距离 >> skipShift) 加大步长，0 表示逐字节查找
+    bool lazy;  // 惰性匹配：下一个位置的匹配更长时先输出一个字面量
+    uint32_t blockSize;  // 块大小
+    bool entropy;  // 是否对LZ输出再做Huffman编码
+};
+
+/*
+ * @brief 面向吞吐的LZ77压缩器（LZ4风格的字节对齐格式）
+ * @description 每个块编码为若干序列，每个序列为：
+ *  1. 标记字节：高4位为字面量长度，低4位为匹配长度-4，取值15时后跟扩展长度字节（每字节累加，遇到非255结束）
+ *  2. 字面量
+ *  3. 匹配偏移（2字节，小端）和匹配长度扩展字节
+ *  块的最后一个序列只有字面量，没有匹配部分
+*/
+class LZ77Compress : public ICompress {
+ public:
+    CompressType getCompressType() const override { return CompressType::LZ77; }
+    std::string getCompressTypeName() const override { return "LZ77"; }
+    // 压缩文件，返回压缩后的文件路径（源路径 + ".lz"）
+    std::string compressFile(const std::string& sourcePath) override;
+    bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    // 压缩/解压内存数据，格式与文件相同
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    // 级别1只查一次哈希表并跳过难以压缩的数据；级别越高哈希链搜索越深，6级起增加Huffman熵编码阶段
+    void setCompressionLevel(int level) override;
+    int getCompressionLevel() const override { return level; }
+
+    // 获取压缩级别对应的参数
+    static LZLevelParams getLevelParams(int level);
+
+    // 压缩一个块，结果追加到 dst，返回压缩后的大小
+    static size_t compressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& dst,
+                                const LZLevelParams& params = getLevelParams(COMPRESS_MIN_LEVEL));
+    // 解压一个块到 dst（大小必须等于块原始大小），数据损坏时返回false
+    static bool decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize);
+
+ private:
+    int level = COMPRESS_DEFAULT_LEVEL;
+
+    // 压缩输入流写入输出流（输出流需支持 seekp，用于回写文件头）
+    bool compressStream(std::istream& in, std::ostream& out) const;
+    // 读取并校验文件头
+    static bool readHeader(std::istream& in, const std::string& sourceName, LZHead& header);
+    // 逐块解压头之后的数据写入输出流并校验CRC
+    static bool decodeStream(std::istream& in, const std::string& sourceName, const LZHead& header,
+                             std::ostream& out);
+};
+
+#endif  // INCLUDE_LZ77COMPRESS_H_
@@ -0,0 +1,101 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_MEMORYSTREAM_H_
+#define INCLUDE_MEMORYSTREAM_H_
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+/*
+ * @brief 以一段内存为数据源的输入流
+ * @description 直接读取调用方的内存，不复制数据，支持 seekg（分块格式按索引定位数据块时需要）
+*/
+class MemoryInputStream : public std::istream {
+ public:
+    MemoryInputStream(const char* data, size_t size) : std::istream(nullptr), buffer(data, size) {
+        rdbuf(&buffer);
+    }
+
+ private:
+    class Buffer : public std::streambuf {
+     public:
+        Buffer(const char* data, size_t size) {
+            char* begin = const_cast<char*>(data);
+            setg(begin, begin, begin + size);
+        }
+
+     protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+            if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+            off_type base = dir == std::ios_base::beg ? 0 :
+                            dir == std::ios_base::cur ? gptr() - eback() : egptr() - eback();
+            off_type target = base + off;
+            if (target < 0 || target > egptr() - eback()) return pos_type(off_type(-1));
+            setg(eback(), eback() + target, egptr());
+            return pos_type(target);
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    Buffer buffer;
+};
+
+/*
+ * @brief 写入 std::vector<char> 的输出流
+ * @description 写入位置之后的数据按需扩展，支持 seekp（压缩完成后回写文件头时需要）
+*/
+class VectorOutputStream : public std::ostream {
+ public:
+    explicit VectorOutputStream(std::vector<char>& data) : std::ostream(nullptr), buffer(data) {
+        rdbuf(&buffer);
+    }
+
+ private:
+    class Buffer : public std::streambuf {
+     public:
+        explicit Buffer(std::vector<char>& data) : data(data) {}
+
+     protected:
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            if (n <= 0) return 0;
+            if (pos + static_cast<size_t>(n) > data.size()) data.resize(pos + static_cast<size_t>(n));
+            std::memcpy(data.data() + pos, s, static_cast<size_t>(n));
+            pos += static_cast<size_t>(n);
+            return n;
+        }
+
+        int_type overflow(int_type ch) override {
+            if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+            char c = traits_type::to_char_type(ch);
+            xsputn(&c, 1);
+            return ch;
+        }
+
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+            if (!(which & std::ios_base::out)) return pos_type(off_type(-1));
+            off_type base = dir == std::ios_base::beg ? 0 :
+                            dir == std::ios_base::cur ? static_cast<off_type>(pos) : static_cast<off_type>(data.size());
+            off_type target = base + off;
+            if (target < 0 || target > static_cast<off_type>(data.size())) return pos_type(off_type(-1));
+            pos = static_cast<size_t>(target);
+            return pos_type(target);
+        }
+
+        pos_type seekpos(pos_type p, std::ios_base::openmode which) override {
+            return seekoff(off_type(p), std::ios_base::beg, which);
+        }
+
+     private:
+        std::vector<char>& data;
+        size_t pos = 0;
+    };
+
+    Buffer buffer;
+};
+
+#endif  // INCLUDE_MEMORYSTREAM_H_
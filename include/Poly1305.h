@@ -0,0 +1,42 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_POLY1305_H_
+#define INCLUDE_POLY1305_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * @brief Poly1305 一次性消息认证码（RFC 8439）
+ * @description 32字节密钥只能认证一条消息；累加器用5个26位的分量表示，
+ *  只需要32x32→64位乘法，不依赖128位整数
+*/
+class Poly1305 {
+ public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t TAG_SIZE = 16;
+    using Tag = std::array<uint8_t, TAG_SIZE>;
+
+    explicit Poly1305(const uint8_t* key);
+
+    // 追加一段数据
+    void update(const uint8_t* data, size_t size);
+
+    // 结束计算并返回认证标签，之后对象不应再使用
+    Tag finish();
+
+    // 计算一段数据的认证标签
+    static Tag mac(const uint8_t* key, const uint8_t* data, size_t size);
+
+ private:
+    // 处理若干完整的16字节分组，final 为 true 时分组已自带结尾的1（最后一个不完整分组）
+    void blocks(const uint8_t* data, size_t size, bool final);
+
+    uint32_t r[5];
+    uint32_t h[5] = {0, 0, 0, 0, 0};
+    uint32_t pad[4];
+    uint8_t buffer[16];
+    size_t bufferSize = 0;
+};
+
+#endif  // INCLUDE_POLY1305_H_
@@ -0,0 +1,49 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#ifndef INCLUDE_SHA256_H_
+#define INCLUDE_SHA256_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * @brief SHA-256 摘要（FIPS 180-4）
+ * @description 支持分段 update；另提供 HMAC-SHA256 与 PBKDF2-HMAC-SHA256，
+ *  供加密器由用户密码派生密钥
+*/
+class SHA256 {
+ public:
+    static constexpr size_t DIGEST_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 64;
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    SHA256();
+
+    // 追加一段数据
+    void update(const uint8_t* data, size_t size);
+
+    // 结束计算并返回摘要，之后对象不应再使用
+    Digest finish();
+
+    // 计算一段数据的摘要
+    static Digest hash(const uint8_t* data, size_t size);
+
+    // HMAC-SHA256
+    static Digest hmac(const uint8_t* key, size_t keySize, const uint8_t* data, size_t size);
+
+    // PBKDF2-HMAC-SHA256：由密码和盐经 iterations 轮迭代派生 outSize 字节的密钥
+    static void pbkdf2(const std::string& password, const uint8_t* salt, size_t saltSize,
+                       uint32_t iterations, uint8_t* out, size_t outSize);
+
+ private:
+    // 处理一个64字节的分组
+    void compress(const uint8_t* block);
+
+    std::array<uint32_t, 8> state;
+    std::array<uint8_t, BLOCK_SIZE> buffer{};
+    size_t bufferSize = 0;  // buffer 中尚未处理的字节数
+    uint64_t totalSize = 0;  // 已输入的总字节数
+};
+
+#endif  // INCLUDE_SHA256_H_
@@ -31,6 +31,15 @@ class SimpleXOREncrypt : public IEncrypt {
 
     // 解密文件
     bool decryptFile(const std::string& sourcePath, const std::string& destPath, const std::string& key) override;
+
+    // data[i] ^= keystream[i]，运行时按CPU选择 AVX-512 / AVX2 / SSE2 / 逐字节实现，结果完全相同
+    static void xorKeystream(uint8_t* data, const uint8_t* keystream, size_t size);
+    // 当前使用的异或实现名称："avx512"、"avx2"、"sse2" 或 "scalar"
+    static const char* getKernelName();
+
+ private:
+    // 把密钥展开为重复的密钥流（BUFFER_SIZE + 密钥长度），从任意密钥位置开始都能取到连续的一整块
+    static std::vector<uint8_t> expandKey(const std::string& password);
 };
 
 #endif  // INCLUDE_SIMPLEXORENCRYPT_H_
@@ -3,6 +3,7 @@
 #define INCLUDE_UTILS_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <ctime>
@@ -16,10 +17,16 @@ namespace fs = std::filesystem;
 
 bool ReadFile(const std::string& filePath, std::vector<char>& buffer);
 bool WriteFile(const std::string& filePath, const std::vector<char>& buffer);
-// 避免与 Windows API 宏 CopyFile 冲突
+// 避免与 Windows API 宏 CopyFile 冲突；通过 CopyEngine 复制（reflink / copy_file_range / sendfile / 缓冲区）
 bool CopyFileBinary(const std::string& srcPath, const std::string& destPath);
 // 检查目录是否存在并且是否可写
 bool isPathWritable(const std::string& path);
+// 通配符匹配相对路径：* 和 ? 不跨越路径分隔符，** 可以跨越多级目录（"**/" 也匹配零级）
+bool matchGlob(std::string_view pattern, std::string_view path);
+// 路径本身或它的任一上级目录与模式匹配时返回true，即模式选中的是一个文件或整个子目录
+bool matchPathPattern(std::string_view pattern, std::string_view path);
+// 规范化恢复路径模式：使用本地路径分隔符，去掉开头的 "./" 和结尾的分隔符
+std::string normalizePathPattern(const std::string& pattern);
 
 
 #endif  // INCLUDE_UTILS_H_
@@ -8,8 +8,14 @@
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <string_view>
 #include <vector>
 
+#define PACK_BUFFER_SIZE (1 << 20)  // 打包/解包时复制文件内容的缓冲区大小 1MB
+#define PACK_PREFETCH_MAX_SIZE (1 << 20)  // 流水线打包时由读取线程预先读入内存的最大文件大小 1MB
+#define PACK_PREFETCH_DEPTH 8  // 流水线打包时每个读取线程的在途文件数
+#define PACK_INDEX_MAGIC 0x434F5442  // 目录索引结尾标记 "BTOC"
+
 // 为了可以更好的还原目录结构，适应多类型支持，需要增加一个数据类型
 enum class FileType : uint8_t{
     Regular = 0,  // 普通文件
@@ -31,28 +37,119 @@ struct FileMeta{
     FileType type;
 };
 
+// 包格式，即包文件的第一个字节（打包标志位）
+enum class PackFormat : uint8_t {
+    Inline = 0x01,  // 旧格式：元信息在包头，其后为文件内容
+    Indexed = 0x02,  // 文件内容在前，末尾为按路径排序的目录索引
+};
+
+// Indexed 格式的包头，其后直接是文件内容
+struct PackHead {
+    PackFormat format;  // 打包标志位，PackFormat::Indexed
+    PackType packType;  // 打包算法
+    uint8_t reserved[6];
+};
+
+// 目录索引项，定长，按路径（逐字节比较）升序排列
+struct PackTocEntry {
+    uint64_t nameOffset;  // 路径在名字区中的偏移
+    uint32_t nameLen;  // 路径长度
+    FileType type;  // 文件类型
+    uint8_t reserved[3];
+    uint64_t size;  // 文件大小
+    uint64_t dataOffset;  // 文件内容在包文件中的偏移
+};
+
+// 包文件末尾的索引位置信息
+struct PackFooter {
+    uint64_t namesOffset;  // 名字区起始位置
+    uint64_t tocOffset;  // 目录索引起始位置（名字区结束位置）
+    uint64_t entryCount;  // 索引项数量
+    uint32_t crc32;  // 名字区与目录索引的CRC32
+    uint32_t magic;  // PACK_INDEX_MAGIC
+};
+
 /*
  * @brief 基础打包器类，实现基本的文件打包与解包功能。
- * @description 打包文件格式为：
- *  1. 打包标志位（1字节），固定为0x01
- *  2. 打包算法（1字节）
- *  3. 当前包包含的文件数量（4字节）
- *  4. 元数据区长度（4字节）
- *  5. 文件元信息 : 文件名长度（4字节） 文件名(变长) 文件大小（8字节） 偏移量（8字节） 文件类型（1字节）
- *  6. 文件内容（按顺序排列）
+ * @description 打包文件格式（PackFormat::Indexed）为：
+ *  1. 包头 PackHead（8字节）：打包标志位0x02、打包算法
+ *  2. 文件内容（按打包顺序排列）
+ *  3. 名字区：各文件的相对路径，按路径排序依次排列
+ *  4. 目录索引：PackTocEntry 数组，按路径排序，可以二分查找
+ *  5. PackFooter：名字区/目录索引的位置、索引项数量、CRC32、结尾标记
+ *  写入时文件内容可以直接流式写出，元信息最后写入；
+ *  仍可读取旧格式（PackFormat::Inline）：打包标志位0x01、打包算法、文件数量（4字节）、元数据区长度（4字节）、
+ *  文件元信息（文件名长度（4字节） 文件名(变长) 文件大小（8字节） 偏移量（8字节） 文件类型（1字节））、文件内容
 */
 //  haed + content   -->  文件夹结构（先根遍历） -->  root + 文件名
 // 获得path  -->  判断类型  --> 目录文件 -->  文件遍历  -->  |  文件list   -->  下游操作
 
+/*
+ * @brief 包文件的目录
+ * @description 读取两种格式的元信息，条目按路径排序；Indexed 格式只需读取文件末尾的名字区和定长索引，
+ *  不逐条解析，按路径查找为二分查找
+*/
+class PackIndex {
+ public:
+    // 读取包文件的目录，失败时返回false
+    bool load(const std::string& srcPath);
+
+    PackFormat getFormat() const { return format; }
+
+    // 条目数量
+    size_t size() const { return entries.size(); }
+
+    // 第 i 个条目（按路径排序），offset 为文件内容在包文件中的偏移
+    FileMeta get(size_t i) const;
+
+    // 按路径查找条目，返回条目序号，找不到时返回 size()
+    size_t find(std::string_view name) const;
+
+    // 第一个路径不小于 name 的条目序号，没有时返回 size()
+    size_t lowerBound(std::string_view name) const;
+
+    // 路径或其上级目录与任一模式（见 matchPathPattern）匹配的条目序号，升序；
+    // 只检查以模式中第一个通配符之前的字面前缀开头的那一段条目
+    std::vector<size_t> match(const std::vector<std::string>& patterns) const;
+
+ private:
+    bool loadIndexed(std::ifstream& in, uint64_t fileSize);
+    bool loadInline(std::ifstream& in, uint64_t fileSize);
+
+    std::string_view nameOf(size_t i) const {
+        return std::string_view(names).substr(entries[i].nameOffset, entries[i].nameLen);
+    }
+
+    PackFormat format = PackFormat::Indexed;
+    std::vector<PackTocEntry> entries;
+    std::string names;
+};
+
 class myPack : public IPack {
  public:
     std::string myPack::pack(const std::vector<std::string>& files, const std::string& destPath) override;
 
     bool myPack::unpack(const std::string& srcPath, const std::string& destDir) override;
 
+    // 只解包路径与 patterns 中任一模式匹配的文件或目录（目录连同其下全部内容），
+    // 通过目录索引直接定位到匹配文件的内容，其余文件不读取
+    bool unpack(const std::string& srcPath, const std::string& destDir,
+                const std::vector<std::string>& patterns) override;
+
     PackType getPackType() const override { return PackType::Basic; }
 
     std::string getPackTypeName() const override { return "Basic"; }
+
+    // 设置/获取打包时读取文件的线程数，0 表示使用硬件并发数，1 表示在主线程逐个读取
+    void setThreadCount(size_t count) { threadCount = count; }
+    size_t getThreadCount() const { return threadCount; }
+
+ private:
+    // 把一个条目还原到 destDir 下，in 为打开的包文件
+    bool extractEntry(std::ifstream& in, const std::string& srcPath, const FileMeta& meta,
+                      const std::string& destDir);
+
+    size_t threadCount = 0;
 };
 
 
@@ -0,0 +1,368 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "AESEncrypt.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AES_HAS_AESNI 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define AES_TARGET_AESNI
+#else
+#define AES_TARGET_AESNI __attribute__((target("aes,sse4.1")))
+#endif
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define AES_HAS_ARMV8 1
+#include <arm_neon.h>
+#if defined(__clang__)
+#define AES_TARGET_ARMV8 __attribute__((target("aes")))
+#else
+#define AES_TARGET_ARMV8 __attribute__((target("+crypto")))
+#endif
+#endif
+
+namespace {
+
+constexpr int kParallelBlocks = 8;  // 硬件实现每次并行加密的计数器块数
+
+// GF(2^8) 上乘以 x（模 x^8 + x^4 + x^3 + x + 1）
+constexpr uint8_t xtime(uint8_t x) {
+    return static_cast<uint8_t>((x << 1) ^ ((x & 0x80) ? 0x1B : 0));
+}
+
+constexpr uint8_t rotl8(uint8_t x, int n) {
+    return static_cast<uint8_t>((x << n) | (x >> (8 - n)));
+}
+
+// 编译期生成S盒：p 遍历 GF(2^8) 的乘法群（生成元3），q 同步为 p 的逆元，再做仿射变换
+constexpr std::array<uint8_t, 256> makeSbox() {
+    std::array<uint8_t, 256> sbox{};
+    uint8_t p = 1, q = 1;
+    do {
+        p = static_cast<uint8_t>(p ^ xtime(p));
+        q = static_cast<uint8_t>(q ^ (q << 1));
+        q = static_cast<uint8_t>(q ^ (q << 2));
+        q = static_cast<uint8_t>(q ^ (q << 4));
+        if (q & 0x80) q ^= 0x09;
+        sbox[p] = static_cast<uint8_t>(q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3) ^ rotl8(q, 4) ^ 0x63);
+    } while (p != 1);
+    sbox[0] = 0x63;
+    return sbox;
+}
+
+constexpr std::array<uint8_t, 256> kSbox = makeSbox();
+
+// T表：tables[0][x] 为 S(x) 经列混合后的一列 {2S, S, S, 3S}（大端字），tables[k] 为其循环右移 8k 位，
+// 一轮的字节代换、行移位、列混合合并为每列4次查表
+using TTables = std::array<std::array<uint32_t, 256>, 4>;
+
+constexpr TTables makeTTables() {
+    TTables tables{};
+    for (int i = 0; i < 256; ++i) {
+        uint8_t s = kSbox[i];
+        uint8_t s2 = xtime(s);
+        uint8_t s3 = static_cast<uint8_t>(s2 ^ s);
+        uint32_t word = (static_cast<uint32_t>(s2) << 24) | (static_cast<uint32_t>(s) << 16) |
+                        (static_cast<uint32_t>(s) << 8) | s3;
+        for (int k = 0; k < 4; ++k) {
+            tables[k][i] = word;
+            word = (word >> 8) | (word << 24);
+        }
+    }
+    return tables;
+}
+
+constexpr TTables kTTables = makeTTables();
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+inline uint32_t subWord(uint32_t w) {
+    return (static_cast<uint32_t>(kSbox[w >> 24]) << 24) | (static_cast<uint32_t>(kSbox[(w >> 16) & 0xFF]) << 16) |
+           (static_cast<uint32_t>(kSbox[(w >> 8) & 0xFF]) << 8) | kSbox[w & 0xFF];
+}
+
+// 第 counter 块的计数器块：nonce(8字节) || 大端 counter
+inline void makeCounterBlock(const uint8_t* nonce, uint64_t counter, uint8_t* block) {
+    std::memcpy(block, nonce, CIPHER_NONCE_SIZE);
+    storeBE32(block + 8, static_cast<uint32_t>(counter >> 32));
+    storeBE32(block + 12, static_cast<uint32_t>(counter));
+}
+
+inline void xorBytes(uint8_t* data, const uint8_t* keystream, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        data[i] ^= keystream[i];
+    }
+}
+
+using CtrFunction = void (*)(const AES256&, const uint8_t*, const uint8_t*, uint64_t, uint8_t*, size_t);
+
+void ctrTable(const AES256& aes, const uint8_t*, const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) {
+    aes.ctrXorPortable(nonce, counter, data, size);
+}
+
+#if defined(AES_HAS_AESNI)
+inline uint64_t byteSwap64(uint64_t v) {
+    v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+}
+
+AES_TARGET_AESNI inline __m128i encryptAesni(__m128i x, const __m128i* rk) {
+    x = _mm_xor_si128(x, rk[0]);
+    for (int r = 1; r < AES256::ROUNDS; ++r) {
+        x = _mm_aesenc_si128(x, rk[r]);
+    }
+    return _mm_aesenclast_si128(x, rk[AES256::ROUNDS]);
+}
+
+// 每次并行加密8个计数器块：aesenc 延迟数个周期但每周期可发射一条，8条互不依赖的链可以填满流水线
+AES_TARGET_AESNI void ctrAesni(const AES256&, const uint8_t* roundKeyBytes, const uint8_t* nonce,
+                               uint64_t counter, uint8_t* data, size_t size) {
+    __m128i rk[AES256::ROUNDS + 1];
+    for (int r = 0; r <= AES256::ROUNDS; ++r) {
+        rk[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(roundKeyBytes + r * 16));
+    }
+    uint64_t nonceWord;
+    std::memcpy(&nonceWord, nonce, sizeof(nonceWord));
+    const long long lo = static_cast<long long>(nonceWord);
+
+    while (size >= kParallelBlocks * AES256::BLOCK_SIZE) {
+        __m128i b0 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter)), lo), rk[0]);
+        __m128i b1 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 1)), lo), rk[0]);
+        __m128i b2 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 2)), lo), rk[0]);
+        __m128i b3 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 3)), lo), rk[0]);
+        __m128i b4 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 4)), lo), rk[0]);
+        __m128i b5 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 5)), lo), rk[0]);
+        __m128i b6 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 6)), lo), rk[0]);
+        __m128i b7 = _mm_xor_si128(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter + 7)), lo), rk[0]);
+        for (int r = 1; r < AES256::ROUNDS; ++r) {
+            b0 = _mm_aesenc_si128(b0, rk[r]);
+            b1 = _mm_aesenc_si128(b1, rk[r]);
+            b2 = _mm_aesenc_si128(b2, rk[r]);
+            b3 = _mm_aesenc_si128(b3, rk[r]);
+            b4 = _mm_aesenc_si128(b4, rk[r]);
+            b5 = _mm_aesenc_si128(b5, rk[r]);
+            b6 = _mm_aesenc_si128(b6, rk[r]);
+            b7 = _mm_aesenc_si128(b7, rk[r]);
+        }
+        const __m128i last = rk[AES256::ROUNDS];
+        __m128i* out = reinterpret_cast<__m128i*>(data);
+        _mm_storeu_si128(out + 0, _mm_xor_si128(_mm_loadu_si128(out + 0), _mm_aesenclast_si128(b0, last)));
+        _mm_storeu_si128(out + 1, _mm_xor_si128(_mm_loadu_si128(out + 1), _mm_aesenclast_si128(b1, last)));
+        _mm_storeu_si128(out + 2, _mm_xor_si128(_mm_loadu_si128(out + 2), _mm_aesenclast_si128(b2, last)));
+        _mm_storeu_si128(out + 3, _mm_xor_si128(_mm_loadu_si128(out + 3), _mm_aesenclast_si128(b3, last)));
+        _mm_storeu_si128(out + 4, _mm_xor_si128(_mm_loadu_si128(out + 4), _mm_aesenclast_si128(b4, last)));
+        _mm_storeu_si128(out + 5, _mm_xor_si128(_mm_loadu_si128(out + 5), _mm_aesenclast_si128(b5, last)));
+        _mm_storeu_si128(out + 6, _mm_xor_si128(_mm_loadu_si128(out + 6), _mm_aesenclast_si128(b6, last)));
+        _mm_storeu_si128(out + 7, _mm_xor_si128(_mm_loadu_si128(out + 7), _mm_aesenclast_si128(b7, last)));
+        counter += kParallelBlocks;
+        data += kParallelBlocks * AES256::BLOCK_SIZE;
+        size -= kParallelBlocks * AES256::BLOCK_SIZE;
+    }
+
+    // 剩余不足8块的部分逐块处理，最后不足16字节的部分只取用所需的密钥流
+    while (size > 0) {
+        __m128i keystream = encryptAesni(_mm_set_epi64x(static_cast<long long>(byteSwap64(counter)), lo), rk);
+        if (size >= AES256::BLOCK_SIZE) {
+            __m128i* out = reinterpret_cast<__m128i*>(data);
+            _mm_storeu_si128(out, _mm_xor_si128(_mm_loadu_si128(out), keystream));
+            data += AES256::BLOCK_SIZE;
+            size -= AES256::BLOCK_SIZE;
+            ++counter;
+        } else {
+            alignas(16) uint8_t block[AES256::BLOCK_SIZE];
+            _mm_store_si128(reinterpret_cast<__m128i*>(block), keystream);
+            xorBytes(data, block, size);
+            size = 0;
+        }
+    }
+}
+#endif  // AES_HAS_AESNI
+
+#if defined(AES_HAS_ARMV8)
+// AESE 先异或轮密钥再做字节代换与行移位，AESMC 做列混合，因此最后一轮之后再单独异或最后一个轮密钥
+AES_TARGET_ARMV8 inline uint8x16_t encryptArmv8(uint8x16_t x, const uint8x16_t* rk) {
+    for (int r = 0; r < AES256::ROUNDS - 1; ++r) {
+        x = vaesmcq_u8(vaeseq_u8(x, rk[r]));
+    }
+    x = vaeseq_u8(x, rk[AES256::ROUNDS - 1]);
+    return veorq_u8(x, rk[AES256::ROUNDS]);
+}
+
+AES_TARGET_ARMV8 void ctrArmv8(const AES256&, const uint8_t* roundKeyBytes, const uint8_t* nonce,
+                               uint64_t counter, uint8_t* data, size_t size) {
+    uint8x16_t rk[AES256::ROUNDS + 1];
+    for (int r = 0; r <= AES256::ROUNDS; ++r) {
+        rk[r] = vld1q_u8(roundKeyBytes + r * 16);
+    }
+    uint8_t counters[kParallelBlocks * AES256::BLOCK_SIZE];
+
+    while (size >= kParallelBlocks * AES256::BLOCK_SIZE) {
+        for (int j = 0; j < kParallelBlocks; ++j) {
+            makeCounterBlock(nonce, counter + j, counters + j * AES256::BLOCK_SIZE);
+        }
+        uint8x16_t b[kParallelBlocks];
+        for (int j = 0; j < kParallelBlocks; ++j) {
+            b[j] = vld1q_u8(counters + j * AES256::BLOCK_SIZE);
+        }
+        for (int r = 0; r < AES256::ROUNDS - 1; ++r) {
+            for (int j = 0; j < kParallelBlocks; ++j) {
+                b[j] = vaesmcq_u8(vaeseq_u8(b[j], rk[r]));
+            }
+        }
+        for (int j = 0; j < kParallelBlocks; ++j) {
+            uint8x16_t keystream = veorq_u8(vaeseq_u8(b[j], rk[AES256::ROUNDS - 1]), rk[AES256::ROUNDS]);
+            uint8_t* out = data + j * AES256::BLOCK_SIZE;
+            vst1q_u8(out, veorq_u8(vld1q_u8(out), keystream));
+        }
+        counter += kParallelBlocks;
+        data += kParallelBlocks * AES256::BLOCK_SIZE;
+        size -= kParallelBlocks * AES256::BLOCK_SIZE;
+    }
+
+    while (size > 0) {
+        makeCounterBlock(nonce, counter, counters);
+        uint8x16_t keystream = encryptArmv8(vld1q_u8(counters), rk);
+        if (size >= AES256::BLOCK_SIZE) {
+            vst1q_u8(data, veorq_u8(vld1q_u8(data), keystream));
+            data += AES256::BLOCK_SIZE;
+            size -= AES256::BLOCK_SIZE;
+            ++counter;
+        } else {
+            vst1q_u8(counters, keystream);
+            xorBytes(data, counters, size);
+            size = 0;
+        }
+    }
+}
+#endif  // AES_HAS_ARMV8
+
+struct CtrImplementation {
+    CtrFunction function;
+    const char* name;
+};
+
+// 首次使用时按CPU特性选择一次
+const CtrImplementation& selectImplementation() {
+    static const CtrImplementation implementation = []() -> CtrImplementation {
+#if defined(AES_HAS_AESNI)
+        if (CpuFeatures::get().aesni && CpuFeatures::get().sse41) return {ctrAesni, "aesni"};
+#endif
+#if defined(AES_HAS_ARMV8)
+        if (CpuFeatures::get().armAes) return {ctrArmv8, "armv8-aes"};
+#endif
+        return {ctrTable, "table"};
+    }();
+    return implementation;
+}
+
+}  // namespace
+
+AES256::AES256(const uint8_t* key) {
+    // 密钥扩展：Nk = 8，共 4 * (ROUNDS + 1) = 60 个字
+    constexpr int nk = KEY_SIZE / 4;
+    uint32_t rcon = 0x01;
+    for (int i = 0; i < nk; ++i) {
+        roundKeys[i] = loadBE32(key + i * 4);
+    }
+    for (size_t i = nk; i < roundKeys.size(); ++i) {
+        uint32_t temp = roundKeys[i - 1];
+        if (i % nk == 0) {
+            temp = subWord((temp << 8) | (temp >> 24)) ^ (rcon << 24);
+            rcon = xtime(static_cast<uint8_t>(rcon));
+        } else if (i % nk == 4) {
+            temp = subWord(temp);
+        }
+        roundKeys[i] = roundKeys[i - nk] ^ temp;
+    }
+    for (size_t i = 0; i < roundKeys.size(); ++i) {
+        storeBE32(roundKeyBytes.data() + i * 4, roundKeys[i]);
+    }
+}
+
+void AES256::encryptBlock(const uint8_t* in, uint8_t* out) const {
+    const auto& t = kTTables;
+    const uint32_t* rk = roundKeys.data();
+    uint32_t s0 = loadBE32(in) ^ rk[0];
+    uint32_t s1 = loadBE32(in + 4) ^ rk[1];
+    uint32_t s2 = loadBE32(in + 8) ^ rk[2];
+    uint32_t s3 = loadBE32(in + 12) ^ rk[3];
+    for (int r = 1; r < ROUNDS; ++r) {
+        rk += 4;
+        uint32_t t0 = t[0][s0 >> 24] ^ t[1][(s1 >> 16) & 0xFF] ^ t[2][(s2 >> 8) & 0xFF] ^ t[3][s3 & 0xFF] ^ rk[0];
+        uint32_t t1 = t[0][s1 >> 24] ^ t[1][(s2 >> 16) & 0xFF] ^ t[2][(s3 >> 8) & 0xFF] ^ t[3][s0 & 0xFF] ^ rk[1];
+        uint32_t t2 = t[0][s2 >> 24] ^ t[1][(s3 >> 16) & 0xFF] ^ t[2][(s0 >> 8) & 0xFF] ^ t[3][s1 & 0xFF] ^ rk[2];
+        uint32_t t3 = t[0][s3 >> 24] ^ t[1][(s0 >> 16) & 0xFF] ^ t[2][(s1 >> 8) & 0xFF] ^ t[3][s2 & 0xFF] ^ rk[3];
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+    // 最后一轮没有列混合，直接查S盒
+    rk += 4;
+    auto lastRound = [](uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t k) {
+        return ((static_cast<uint32_t>(kSbox[a >> 24]) << 24) | (static_cast<uint32_t>(kSbox[(b >> 16) & 0xFF]) << 16) |
+                (static_cast<uint32_t>(kSbox[(c >> 8) & 0xFF]) << 8) | kSbox[d & 0xFF]) ^ k;
+    };
+    storeBE32(out, lastRound(s0, s1, s2, s3, rk[0]));
+    storeBE32(out + 4, lastRound(s1, s2, s3, s0, rk[1]));
+    storeBE32(out + 8, lastRound(s2, s3, s0, s1, rk[2]));
+    storeBE32(out + 12, lastRound(s3, s0, s1, s2, rk[3]));
+}
+
+void AES256::ctrXorPortable(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const {
+    uint8_t block[BLOCK_SIZE];
+    uint8_t keystream[BLOCK_SIZE];
+    while (size > 0) {
+        makeCounterBlock(nonce, counter++, block);
+        encryptBlock(block, keystream);
+        size_t n = std::min(size, BLOCK_SIZE);
+        xorBytes(data, keystream, n);
+        data += n;
+        size -= n;
+    }
+}
+
+void AES256::ctrXor(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const {
+    selectImplementation().function(*this, roundKeyBytes.data(), nonce, counter, data, size);
+}
+
+const char* AES256::getImplementationName() {
+    return selectImplementation().name;
+}
+
+namespace {
+
+// AES-256-CTR 密钥流
+class AESKeystream : public IKeystream {
+ public:
+    explicit AESKeystream(const uint8_t* key) : aes(key) {}
+
+    void apply(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const override {
+        aes.ctrXor(nonce, counter, data, size);
+    }
+
+    size_t blockSize() const override { return AES256::BLOCK_SIZE; }
+
+ private:
+    AES256 aes;
+};
+
+}  // namespace
+
+std::unique_ptr<IKeystream> AESEncrypt::createKeystream(const uint8_t* key) const {
+    return std::make_unique<AESKeystream>(key);
+}
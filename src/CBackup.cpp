@@ -1,5 +1,6 @@
 // Copyright [2025] <JiJun Lu, Linru Zhou>
 #include "CBackup.h"
+#include <algorithm>
 
 /**
  * CBackup implementation
@@ -56,12 +57,58 @@ std::vector<std::string> collectFilesToBackup(const std::string& rootPath, const
     return filesList;
 }
 
+// 非打包备份的选择性恢复：相对路径以 restorePath 的名字开头，与打包时包内的路径一致
+static bool restoreMatchedPaths(const fs::path& backupPath, const fs::path& restorePath,
+                                const std::vector<std::string>& paths) {
+    std::vector<std::string> patterns;
+    for (const std::string& path : paths) {
+        patterns.push_back(normalizePathPattern(path));
+    }
+    auto matches = [&patterns](const fs::path& relative) {
+        const std::string name = relative.string();
+        return std::any_of(patterns.begin(), patterns.end(),
+                           [&name](const std::string& pattern) { return matchPathPattern(pattern, name); });
+    };
+
+    size_t restored = 0;
+    const fs::path rootName = restorePath.filename();
+    if (fs::is_regular_file(backupPath)) {
+        if (matches(rootName)) {
+            fs::copy_file(backupPath, restorePath, fs::copy_options::overwrite_existing);
+            ++restored;
+        }
+    } else {
+        for (const auto& item : fs::recursive_directory_iterator(backupPath)) {
+            const fs::path relative = item.path().lexically_relative(backupPath);
+            if (!matches(rootName / relative)) continue;
+            const fs::path target = restorePath / relative;
+            if (item.is_directory() && !item.is_symlink()) {
+                fs::create_directories(target);
+            } else {
+                fs::create_directories(target.parent_path());
+                fs::copy(item.path(), target, fs::copy_options::overwrite_existing | fs::copy_options::copy_symlinks);
+            }
+            ++restored;
+        }
+    }
+    if (restored == 0) {
+        std::cerr << "Error: No files in " << backupPath.string() << " match the requested paths." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
     // 保持向后兼容：默认调用带密码参数的重载，传入空密码表示需要内部交互
     return doRecovery(entry, destDir, std::string());
 }
 
 bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, const std::string& password) {
+    return doRecovery(entry, destDir, password, std::vector<std::string>());
+}
+
+bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, const std::string& password,
+                         const std::vector<std::string>& paths) {
     // 基础恢复：
     // - 若是打包：调用解包器（此处保留输出提示，具体实现按打包器完成）
     // - 若非打包：从备份目录将文件按原始相对路径复制回去
@@ -177,8 +224,10 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
             std::cerr << "Error: Failed to create packer: " << e.what() << std::endl;
             return false;
         }
-        // 解包到源文件目录
-        if (!packer->unpack(backupRoot + "/" + backupName, destDir)) {
+        // 解包到源文件目录，指定了路径时只解包匹配的部分
+        bool unpacked = paths.empty() ? packer->unpack(backupRoot + "/" + backupName, destDir)
+                                      : packer->unpack(backupRoot + "/" + backupName, destDir, paths);
+        if (!unpacked) {
             std::cerr << "Error: Failed to unpack file: " << backupName << std::endl;
             return false;
         }
@@ -212,6 +261,9 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
         }
         // 直接复制就不太一样，backupPath是新增的一个目录路径，真正的路径还要再下一个文件
         fs::path actualBackupPath = fs::path(backupPath) / entry.fileName;
+        if (!paths.empty()) {
+            return restoreMatchedPaths(actualBackupPath, restorePath, paths);
+        }
         if (fs::is_directory(actualBackupPath)) {
             // 目录复制：使用recursive选项
             fs::copy(actualBackupPath, restorePath,
@@ -303,6 +355,7 @@ std::string CBackup::doBackup(const std::shared_ptr<CConfig>& config) {
                 std::cerr << "Error: Failed to create compress: " << e.what() << std::endl;
                 return "";
             }
+            compress->setCompressionLevel(config->getCompressionLevel());
             // 这个路径需要斟酌一下，或许增加一个后缀，总之是要将之前的文件给覆盖了
             compressedFilePath = compress->compressFile(packedFilePath);
             destPath = compressedFilePath;
@@ -416,7 +469,11 @@ std::string CBackup::doBackup(const std::shared_ptr<CConfig>& config) {
                     // 确保目标文件的父目录存在
                     fs::create_directories(destinationPath.parent_path());
                     // 复制文件
-                    CopyFileBinary(entry, destinationPath.string());
+                    if (!CopyFileBinary(entry, destinationPath.string())) {
+                        std::cerr << "Error: Failed to copy " << entry << " to " << destinationPath.string()
+                                  << std::endl;
+                        return "";
+                    }
                 }
             } catch (const std::exception& e) {
                 std::cerr << "Error processing " << entry << ": " << e.what() << std::endl;
@@ -296,7 +296,7 @@ void CConfig::reset() {
     m_packType = "tar";
     m_enableCompression = false;
     m_compressionType = "gzip";
-    m_compressionLevel = 1;
+    m_compressionLevel = COMPRESS_DEFAULT_LEVEL;
     m_enableEncryption = false;
     m_encryptionKey.clear();
 
@@ -0,0 +1,210 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "CRC32.h"
+#include "CpuFeatures.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC32_HAS_PCLMUL 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define CRC32_TARGET_PCLMUL
+#else
+#define CRC32_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#endif
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32_HAS_ARMV8 1
+#include <arm_acle.h>
+#if defined(__clang__)
+#define CRC32_TARGET_ARMV8 __attribute__((target("crc")))
+#else
+#define CRC32_TARGET_ARMV8 __attribute__((target("+crc")))
+#endif
+#endif
+
+namespace {
+
+using UpdateFunction = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+#if defined(CRC32_HAS_PCLMUL)
+// 折叠常数（反射形式，见 Intel《Fast CRC Computation Using PCLMULQDQ Instruction》）：
+// k1/k2 每次折叠4x128位，k3/k4 折叠128位，k5 由128位折叠到64位，poly 为 Barrett 约减所需的 P(x) 与 u
+alignas(16) const uint64_t kFold4[2] = {0x0154442bd4, 0x01c6e41596};
+alignas(16) const uint64_t kFold1[2] = {0x01751997d0, 0x00ccaa009e};
+alignas(16) const uint64_t kFold64[2] = {0x0163cd6124, 0x0000000000};
+alignas(16) const uint64_t kBarrett[2] = {0x01db710641, 0x01f7011641};
+
+// 把 acc 折叠到下一个128位数据上
+CRC32_TARGET_PCLMUL inline __m128i fold128(__m128i acc, __m128i next, __m128i k) {
+    __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+// 对至少64字节、长度为16的倍数的数据做无进位乘法折叠，最后用 Barrett 约减得到32位CRC
+CRC32_TARGET_PCLMUL uint32_t foldPclmul(uint32_t crc, const uint8_t* data, size_t size) {
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(kFold4));
+    data += 64;
+    size -= 64;
+
+    // 4路并行，每次折叠64字节
+    while (size >= 64) {
+        __m128i l1 = _mm_clmulepi64_si128(x1, k, 0x00);
+        __m128i l2 = _mm_clmulepi64_si128(x2, k, 0x00);
+        __m128i l3 = _mm_clmulepi64_si128(x3, k, 0x00);
+        __m128i l4 = _mm_clmulepi64_si128(x4, k, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, l1), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, l2), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, l3), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, l4), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)));
+        data += 64;
+        size -= 64;
+    }
+
+    // 4个128位合并为1个
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(kFold1));
+    x1 = fold128(x1, x2, k);
+    x1 = fold128(x1, x3, k);
+    x1 = fold128(x1, x4, k);
+
+    // 剩余的16字节块
+    while (size >= 16) {
+        x1 = fold128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), k);
+        data += 16;
+        size -= 16;
+    }
+
+    // 128位折叠到64位
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kFold64));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett 约减到32位
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(kBarrett));
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+uint32_t updatePclmul(uint32_t crc, const uint8_t* data, size_t size) {
+    if (size >= 64) {
+        size_t folded = size & ~static_cast<size_t>(15);
+        crc = foldPclmul(crc, data, folded);
+        data += folded;
+        size -= folded;
+    }
+    return CRC32::updateTable(crc, data, size);
+}
+#endif  // CRC32_HAS_PCLMUL
+
+#if defined(CRC32_HAS_ARMV8)
+// ARMv8 CRC32 指令直接实现 IEEE 多项式，每条指令处理8字节
+CRC32_TARGET_ARMV8 uint32_t updateArmv8(uint32_t crc, const uint8_t* data, size_t size) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32d(crc, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = __crc32b(crc, *data++);
+    }
+    return crc;
+}
+#endif  // CRC32_HAS_ARMV8
+
+// GF(2) 上的 32x32 矩阵乘向量：矩阵按列存储，vec 的第 i 位为1时累加第 i 列
+uint32_t gf2MatrixTimes(const uint32_t* matrix, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) sum ^= *matrix;
+        vec >>= 1;
+        ++matrix;
+    }
+    return sum;
+}
+
+// square = matrix * matrix
+void gf2MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+    for (int n = 0; n < 32; ++n) {
+        square[n] = gf2MatrixTimes(matrix, matrix[n]);
+    }
+}
+
+struct Implementation {
+    UpdateFunction update;
+    const char* name;
+};
+
+// 首次使用时检测一次CPU特性
+const Implementation& selectImplementation() {
+    static const Implementation implementation = []() -> Implementation {
+#if defined(CRC32_HAS_PCLMUL)
+        if (CpuFeatures::get().pclmul && CpuFeatures::get().sse41) return {updatePclmul, "pclmul"};
+#endif
+#if defined(CRC32_HAS_ARMV8)
+        if (CpuFeatures::get().armCrc32) return {updateArmv8, "armv8-crc"};
+#endif
+        return {CRC32::updateTable, "table"};
+    }();
+    return implementation;
+}
+
+}  // namespace
+
+uint32_t CRC32::update(uint32_t crc, const uint8_t* data, size_t size) {
+    return selectImplementation().update(crc, data, size);
+}
+
+const char* CRC32::getImplementationName() {
+    return selectImplementation().name;
+}
+
+uint32_t CRC32::combine(uint32_t crcA, uint32_t crcB, uint64_t lenB) {
+    if (lenB == 0) return crcA;
+
+    // CRC 对数据是线性的：crc(A || B) = crc(A 后接 lenB 个零字节) ^ crc(B)，
+    // 在 crcA 后追加零字节相当于乘以一个 32x32 的矩阵，用平方求幂在 O(log lenB) 次矩阵运算内完成
+    uint32_t even[32];  // 追加 2^k 个零位的矩阵（k 为偶数次平方）
+    uint32_t odd[32];  // 追加 2^k 个零位的矩阵（k 为奇数次平方）
+
+    // 追加一个零位的矩阵
+    odd[0] = crc32_detail::kPolynomial;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    gf2MatrixSquare(even, odd);  // 2个零位
+    gf2MatrixSquare(odd, even);  // 4个零位
+
+    // 每轮平方后得到追加 1、2、4... 个零字节的矩阵，lenB 对应位为1时作用到 crcA 上
+    do {
+        gf2MatrixSquare(even, odd);
+        if (lenB & 1) crcA = gf2MatrixTimes(even, crcA);
+        lenB >>= 1;
+        if (lenB == 0) break;
+
+        gf2MatrixSquare(odd, even);
+        if (lenB & 1) crcA = gf2MatrixTimes(odd, crcA);
+        lenB >>= 1;
+    } while (lenB != 0);
+
+    return crcA ^ crcB;
+}
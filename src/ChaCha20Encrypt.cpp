@@ -0,0 +1,402 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "ChaCha20Encrypt.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHACHA_HAS_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define CHACHA_TARGET_AVX2
+#else
+#define CHACHA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CHACHA_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using ChaChaFunction = void (*)(const uint32_t*, uint64_t, uint8_t*, size_t);
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint32_t rotl32(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+inline void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+    a += b; d ^= a; d = rotl32(d, 16);
+    c += d; b ^= c; b = rotl32(b, 12);
+    a += b; d ^= a; d = rotl32(d, 8);
+    c += d; b ^= c; b = rotl32(b, 7);
+}
+
+// 生成块计数为 counter 的一个密钥流块，与 data 的前 size（不超过64）字节异或
+void xorBlockScalar(const uint32_t* state, uint64_t counter, uint8_t* data, size_t size) {
+    uint32_t in[16];
+    std::copy(state, state + 16, in);
+    in[12] = static_cast<uint32_t>(counter);
+    in[13] = static_cast<uint32_t>(counter >> 32);
+    uint32_t x[16];
+    std::copy(in, in + 16, x);
+    for (int i = 0; i < 10; ++i) {
+        // 列轮
+        quarterRound(x[0], x[4], x[8], x[12]);
+        quarterRound(x[1], x[5], x[9], x[13]);
+        quarterRound(x[2], x[6], x[10], x[14]);
+        quarterRound(x[3], x[7], x[11], x[15]);
+        // 对角线轮
+        quarterRound(x[0], x[5], x[10], x[15]);
+        quarterRound(x[1], x[6], x[11], x[12]);
+        quarterRound(x[2], x[7], x[8], x[13]);
+        quarterRound(x[3], x[4], x[9], x[14]);
+    }
+    uint8_t keystream[ChaCha20::BLOCK_SIZE];
+    for (int i = 0; i < 16; ++i) {
+        uint32_t v = x[i] + in[i];
+        keystream[i * 4] = static_cast<uint8_t>(v);
+        keystream[i * 4 + 1] = static_cast<uint8_t>(v >> 8);
+        keystream[i * 4 + 2] = static_cast<uint8_t>(v >> 16);
+        keystream[i * 4 + 3] = static_cast<uint8_t>(v >> 24);
+    }
+    for (size_t i = 0; i < size; ++i) {
+        data[i] ^= keystream[i];
+    }
+}
+
+void xorScalar(const uint32_t* state, uint64_t counter, uint8_t* data, size_t size) {
+    while (size > 0) {
+        size_t n = std::min(size, ChaCha20::BLOCK_SIZE);
+        xorBlockScalar(state, counter++, data, n);
+        data += n;
+        size -= n;
+    }
+}
+
+// 以下向量实现把16个状态字各放在一个向量寄存器中，每个通道是一个独立的块（通道 j 的块计数为 counter + j），
+// 20轮之后再把“按字排列”转置为“按块排列”与数据异或
+
+#if defined(CHACHA_HAS_X86_SIMD)
+template <int N>
+inline __m128i rotlSse2(__m128i x) {
+    return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N));
+}
+
+// 循环左移16位即交换每个字的高低16位
+template <>
+inline __m128i rotlSse2<16>(__m128i x) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+}
+
+inline void quarterRoundSse2(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    a = _mm_add_epi32(a, b); d = rotlSse2<16>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d); b = rotlSse2<12>(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(a, b); d = rotlSse2<8>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d); b = rotlSse2<7>(_mm_xor_si128(b, c));
+}
+
+// 20轮（10次双轮）；状态字复制到独立的局部变量中，编译器才能把它们分配到寄存器而不是每轮读写数组
+inline void roundsSse2(__m128i* x) {
+    __m128i x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3], x4 = x[4], x5 = x[5], x6 = x[6], x7 = x[7];
+    __m128i x8 = x[8], x9 = x[9], x10 = x[10], x11 = x[11], x12 = x[12], x13 = x[13], x14 = x[14], x15 = x[15];
+    for (int r = 0; r < 10; ++r) {
+        quarterRoundSse2(x0, x4, x8, x12);
+        quarterRoundSse2(x1, x5, x9, x13);
+        quarterRoundSse2(x2, x6, x10, x14);
+        quarterRoundSse2(x3, x7, x11, x15);
+        quarterRoundSse2(x0, x5, x10, x15);
+        quarterRoundSse2(x1, x6, x11, x12);
+        quarterRoundSse2(x2, x7, x8, x13);
+        quarterRoundSse2(x3, x4, x9, x14);
+    }
+    x[0] = x0; x[1] = x1; x[2] = x2; x[3] = x3; x[4] = x4; x[5] = x5; x[6] = x6; x[7] = x7;
+    x[8] = x8; x[9] = x9; x[10] = x10; x[11] = x11; x[12] = x12; x[13] = x13; x[14] = x14; x[15] = x15;
+}
+
+// SSE2 是 x86-64 的基础指令集，不需要检测；每次4块（256字节）
+void xorSse2(const uint32_t* state, uint64_t counter, uint8_t* data, size_t size) {
+    constexpr int lanes = 4;
+    while (size >= lanes * ChaCha20::BLOCK_SIZE) {
+        __m128i in[16];
+        for (int i = 0; i < 16; ++i) {
+            in[i] = _mm_set1_epi32(static_cast<int>(state[i]));
+        }
+        in[12] = _mm_setr_epi32(static_cast<int>(counter), static_cast<int>(counter + 1),
+                                static_cast<int>(counter + 2), static_cast<int>(counter + 3));
+        in[13] = _mm_setr_epi32(static_cast<int>(counter >> 32), static_cast<int>((counter + 1) >> 32),
+                                static_cast<int>((counter + 2) >> 32), static_cast<int>((counter + 3) >> 32));
+        __m128i x[16];
+        for (int i = 0; i < 16; ++i) x[i] = in[i];
+        roundsSse2(x);
+        for (int i = 0; i < 16; ++i) x[i] = _mm_add_epi32(x[i], in[i]);
+
+        // 每4个状态字做一次4x4转置，得到4个块各自的16字节
+        for (int g = 0; g < 4; ++g) {
+            __m128i t0 = _mm_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+            __m128i t1 = _mm_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+            __m128i t2 = _mm_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+            __m128i t3 = _mm_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+            const __m128i block[4] = {_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+                                      _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)};
+            for (int j = 0; j < lanes; ++j) {
+                __m128i* p = reinterpret_cast<__m128i*>(data + j * ChaCha20::BLOCK_SIZE + g * 16);
+                _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), block[j]));
+            }
+        }
+        counter += lanes;
+        data += lanes * ChaCha20::BLOCK_SIZE;
+        size -= lanes * ChaCha20::BLOCK_SIZE;
+    }
+    xorScalar(state, counter, data, size);
+}
+
+// 循环左移16位和8位正好是字内字节重排，用一条 vpshufb 完成
+CHACHA_TARGET_AVX2 inline __m256i rotl16Avx2(__m256i x) {
+    const __m256i mask = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                          2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    return _mm256_shuffle_epi8(x, mask);
+}
+
+CHACHA_TARGET_AVX2 inline __m256i rotl8Avx2(__m256i x) {
+    const __m256i mask = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    return _mm256_shuffle_epi8(x, mask);
+}
+
+template <int N>
+CHACHA_TARGET_AVX2 inline __m256i rotlAvx2(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+}
+
+CHACHA_TARGET_AVX2 inline void quarterRoundAvx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+    a = _mm256_add_epi32(a, b); d = rotl16Avx2(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi32(c, d); b = rotlAvx2<12>(_mm256_xor_si256(b, c));
+    a = _mm256_add_epi32(a, b); d = rotl8Avx2(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi32(c, d); b = rotlAvx2<7>(_mm256_xor_si256(b, c));
+}
+
+CHACHA_TARGET_AVX2 inline void roundsAvx2(__m256i* x) {
+    __m256i x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3], x4 = x[4], x5 = x[5], x6 = x[6], x7 = x[7];
+    __m256i x8 = x[8], x9 = x[9], x10 = x[10], x11 = x[11], x12 = x[12], x13 = x[13], x14 = x[14], x15 = x[15];
+    for (int r = 0; r < 10; ++r) {
+        quarterRoundAvx2(x0, x4, x8, x12);
+        quarterRoundAvx2(x1, x5, x9, x13);
+        quarterRoundAvx2(x2, x6, x10, x14);
+        quarterRoundAvx2(x3, x7, x11, x15);
+        quarterRoundAvx2(x0, x5, x10, x15);
+        quarterRoundAvx2(x1, x6, x11, x12);
+        quarterRoundAvx2(x2, x7, x8, x13);
+        quarterRoundAvx2(x3, x4, x9, x14);
+    }
+    x[0] = x0; x[1] = x1; x[2] = x2; x[3] = x3; x[4] = x4; x[5] = x5; x[6] = x6; x[7] = x7;
+    x[8] = x8; x[9] = x9; x[10] = x10; x[11] = x11; x[12] = x12; x[13] = x13; x[14] = x14; x[15] = x15;
+}
+
+// 每次8块（512字节），剩余部分交给 SSE2 和标量实现
+CHACHA_TARGET_AVX2 void xorAvx2(const uint32_t* state, uint64_t counter, uint8_t* data, size_t size) {
+    constexpr int lanes = 8;
+    while (size >= lanes * ChaCha20::BLOCK_SIZE) {
+        __m256i in[16];
+        for (int i = 0; i < 16; ++i) {
+            in[i] = _mm256_set1_epi32(static_cast<int>(state[i]));
+        }
+        alignas(32) uint32_t lo[lanes];
+        alignas(32) uint32_t hi[lanes];
+        for (int j = 0; j < lanes; ++j) {
+            lo[j] = static_cast<uint32_t>(counter + j);
+            hi[j] = static_cast<uint32_t>((counter + j) >> 32);
+        }
+        in[12] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lo));
+        in[13] = _mm256_load_si256(reinterpret_cast<const __m256i*>(hi));
+        __m256i x[16];
+        for (int i = 0; i < 16; ++i) x[i] = in[i];
+        roundsAvx2(x);
+        for (int i = 0; i < 16; ++i) x[i] = _mm256_add_epi32(x[i], in[i]);
+
+        // 在每个128位半区内做4x4转置：block[g][j] 的低半区为块 j 的第 g 个16字节，高半区为块 j + 4 的
+        __m256i block[4][4];
+        for (int g = 0; g < 4; ++g) {
+            __m256i t0 = _mm256_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+            __m256i t1 = _mm256_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+            __m256i t2 = _mm256_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+            __m256i t3 = _mm256_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+            block[g][0] = _mm256_unpacklo_epi64(t0, t1);
+            block[g][1] = _mm256_unpackhi_epi64(t0, t1);
+            block[g][2] = _mm256_unpacklo_epi64(t2, t3);
+            block[g][3] = _mm256_unpackhi_epi64(t2, t3);
+        }
+        // 把相邻两组的半区拼成32字节
+        for (int j = 0; j < 4; ++j) {
+            __m256i* low = reinterpret_cast<__m256i*>(data + j * ChaCha20::BLOCK_SIZE);
+            __m256i* high = reinterpret_cast<__m256i*>(data + (j + 4) * ChaCha20::BLOCK_SIZE);
+            const __m256i k0 = _mm256_permute2x128_si256(block[0][j], block[1][j], 0x20);
+            const __m256i k1 = _mm256_permute2x128_si256(block[2][j], block[3][j], 0x20);
+            const __m256i k2 = _mm256_permute2x128_si256(block[0][j], block[1][j], 0x31);
+            const __m256i k3 = _mm256_permute2x128_si256(block[2][j], block[3][j], 0x31);
+            _mm256_storeu_si256(low, _mm256_xor_si256(_mm256_loadu_si256(low), k0));
+            _mm256_storeu_si256(low + 1, _mm256_xor_si256(_mm256_loadu_si256(low + 1), k1));
+            _mm256_storeu_si256(high, _mm256_xor_si256(_mm256_loadu_si256(high), k2));
+            _mm256_storeu_si256(high + 1, _mm256_xor_si256(_mm256_loadu_si256(high + 1), k3));
+        }
+        counter += lanes;
+        data += lanes * ChaCha20::BLOCK_SIZE;
+        size -= lanes * ChaCha20::BLOCK_SIZE;
+    }
+    xorSse2(state, counter, data, size);
+}
+#endif  // CHACHA_HAS_X86_SIMD
+
+#if defined(CHACHA_HAS_NEON)
+template <int N>
+inline uint32x4_t rotlNeon(uint32x4_t x) {
+    return vsriq_n_u32(vshlq_n_u32(x, N), x, 32 - N);
+}
+
+template <>
+inline uint32x4_t rotlNeon<16>(uint32x4_t x) {
+    return vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(x)));
+}
+
+inline void quarterRoundNeon(uint32x4_t& a, uint32x4_t& b, uint32x4_t& c, uint32x4_t& d) {
+    a = vaddq_u32(a, b); d = rotlNeon<16>(veorq_u32(d, a));
+    c = vaddq_u32(c, d); b = rotlNeon<12>(veorq_u32(b, c));
+    a = vaddq_u32(a, b); d = rotlNeon<8>(veorq_u32(d, a));
+    c = vaddq_u32(c, d); b = rotlNeon<7>(veorq_u32(b, c));
+}
+
+inline void roundsNeon(uint32x4_t* x) {
+    uint32x4_t x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3], x4 = x[4], x5 = x[5], x6 = x[6], x7 = x[7];
+    uint32x4_t x8 = x[8], x9 = x[9], x10 = x[10], x11 = x[11], x12 = x[12], x13 = x[13], x14 = x[14], x15 = x[15];
+    for (int r = 0; r < 10; ++r) {
+        quarterRoundNeon(x0, x4, x8, x12);
+        quarterRoundNeon(x1, x5, x9, x13);
+        quarterRoundNeon(x2, x6, x10, x14);
+        quarterRoundNeon(x3, x7, x11, x15);
+        quarterRoundNeon(x0, x5, x10, x15);
+        quarterRoundNeon(x1, x6, x11, x12);
+        quarterRoundNeon(x2, x7, x8, x13);
+        quarterRoundNeon(x3, x4, x9, x14);
+    }
+    x[0] = x0; x[1] = x1; x[2] = x2; x[3] = x3; x[4] = x4; x[5] = x5; x[6] = x6; x[7] = x7;
+    x[8] = x8; x[9] = x9; x[10] = x10; x[11] = x11; x[12] = x12; x[13] = x13; x[14] = x14; x[15] = x15;
+}
+
+// NEON 是 AArch64 的基础指令集；每次4块（256字节）
+void xorNeon(const uint32_t* state, uint64_t counter, uint8_t* data, size_t size) {
+    constexpr int lanes = 4;
+    while (size >= lanes * ChaCha20::BLOCK_SIZE) {
+        uint32x4_t in[16];
+        for (int i = 0; i < 16; ++i) {
+            in[i] = vdupq_n_u32(state[i]);
+        }
+        uint32_t lo[lanes];
+        uint32_t hi[lanes];
+        for (int j = 0; j < lanes; ++j) {
+            lo[j] = static_cast<uint32_t>(counter + j);
+            hi[j] = static_cast<uint32_t>((counter + j) >> 32);
+        }
+        in[12] = vld1q_u32(lo);
+        in[13] = vld1q_u32(hi);
+        uint32x4_t x[16];
+        for (int i = 0; i < 16; ++i) x[i] = in[i];
+        roundsNeon(x);
+        for (int i = 0; i < 16; ++i) x[i] = vaddq_u32(x[i], in[i]);
+
+        for (int g = 0; g < 4; ++g) {
+            uint32x4x2_t ab = vtrnq_u32(x[4 * g], x[4 * g + 1]);
+            uint32x4x2_t cd = vtrnq_u32(x[4 * g + 2], x[4 * g + 3]);
+            const uint32x4_t block[4] = {vcombine_u32(vget_low_u32(ab.val[0]), vget_low_u32(cd.val[0])),
+                                         vcombine_u32(vget_low_u32(ab.val[1]), vget_low_u32(cd.val[1])),
+                                         vcombine_u32(vget_high_u32(ab.val[0]), vget_high_u32(cd.val[0])),
+                                         vcombine_u32(vget_high_u32(ab.val[1]), vget_high_u32(cd.val[1]))};
+            for (int j = 0; j < lanes; ++j) {
+                uint8_t* p = data + j * ChaCha20::BLOCK_SIZE + g * 16;
+                vst1q_u8(p, veorq_u8(vld1q_u8(p), vreinterpretq_u8_u32(block[j])));
+            }
+        }
+        counter += lanes;
+        data += lanes * ChaCha20::BLOCK_SIZE;
+        size -= lanes * ChaCha20::BLOCK_SIZE;
+    }
+    xorScalar(state, counter, data, size);
+}
+#endif  // CHACHA_HAS_NEON
+
+struct ChaChaImplementation {
+    ChaChaFunction function;
+    const char* name;
+};
+
+// 首次使用时按CPU特性选择一次
+const ChaChaImplementation& selectImplementation() {
+    static const ChaChaImplementation implementation = []() -> ChaChaImplementation {
+#if defined(CHACHA_HAS_X86_SIMD)
+        if (CpuFeatures::get().avx2) return {xorAvx2, "avx2"};
+        return {xorSse2, "sse2"};
+#elif defined(CHACHA_HAS_NEON)
+        return {xorNeon, "neon"};
+#else
+        return {xorScalar, "scalar"};
+#endif
+    }();
+    return implementation;
+}
+
+}  // namespace
+
+ChaCha20::ChaCha20(const uint8_t* key) {
+    for (int i = 0; i < 8; ++i) {
+        keyWords[i] = loadLE32(key + i * 4);
+    }
+}
+
+std::array<uint32_t, 16> ChaCha20::initialState(const uint8_t* nonce) const {
+    // "expand 32-byte k"
+    std::array<uint32_t, 16> state = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    std::copy(keyWords.begin(), keyWords.end(), state.begin() + 4);
+    state[14] = loadLE32(nonce);
+    state[15] = loadLE32(nonce + 4);
+    return state;
+}
+
+void ChaCha20::xorKeystream(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const {
+    const std::array<uint32_t, 16> state = initialState(nonce);
+    selectImplementation().function(state.data(), counter, data, size);
+}
+
+void ChaCha20::xorKeystreamPortable(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const {
+    const std::array<uint32_t, 16> state = initialState(nonce);
+    xorScalar(state.data(), counter, data, size);
+}
+
+const char* ChaCha20::getImplementationName() {
+    return selectImplementation().name;
+}
+
+namespace {
+
+// ChaCha20 密钥流，块计数即 CipherEncrypt 的块号
+class ChaCha20Keystream : public IKeystream {
+ public:
+    explicit ChaCha20Keystream(const uint8_t* key) : chacha(key) {}
+
+    void apply(const uint8_t* nonce, uint64_t counter, uint8_t* data, size_t size) const override {
+        chacha.xorKeystream(nonce, counter, data, size);
+    }
+
+    size_t blockSize() const override { return ChaCha20::BLOCK_SIZE; }
+
+ private:
+    ChaCha20 chacha;
+};
+
+}  // namespace
+
+std::unique_ptr<IKeystream> ChaCha20Encrypt::createKeystream(const uint8_t* key) const {
+    return std::make_unique<ChaCha20Keystream>(key);
+}
@@ -0,0 +1,578 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "CipherEncrypt.h"
+#include "Poly1305.h"
+#include "SHA256.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <random>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 由密码和盐派生密钥，空密码使用默认密钥
+std::array<uint8_t, CIPHER_KEY_SIZE> deriveKey(const std::string& key, const CipherEncHead& head) {
+    std::array<uint8_t, CIPHER_KEY_SIZE> derived;
+    SHA256::pbkdf2(key.empty() ? std::string(DEFAULT_KEY) : key, head.salt, CIPHER_SALT_SIZE, head.iterations,
+                   derived.data(), derived.size());
+    return derived;
+}
+
+inline void storeLE64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+}
+
+// 分块的 Poly1305 一次性密钥取自本块密钥流的开头，数据从其后第一个完整的密钥流块开始加密
+uint64_t dataCounter(const IKeystream& keystream) {
+    return (Poly1305::KEY_SIZE + keystream.blockSize() - 1) / keystream.blockSize();
+}
+
+// 计算分块的认证标签：密文补齐到16字节后，再认证块序号、大小和是否为最后一块，
+// 分块被调换、截断或移到别的位置都无法通过认证
+Poly1305::Tag chunkTag(const IKeystream& keystream, const CipherChunkEntry& entry, uint64_t index, bool last,
+                       const uint8_t* ciphertext) {
+    uint8_t polyKey[Poly1305::KEY_SIZE] = {};
+    keystream.apply(entry.nonce, 0, polyKey, sizeof(polyKey));
+    Poly1305 poly(polyKey);
+    poly.update(ciphertext, entry.size);
+    const uint8_t zeros[16] = {};
+    poly.update(zeros, (16 - entry.size % 16) % 16);
+    uint8_t trailer[16];
+    storeLE64(trailer, index);
+    storeLE64(trailer + 8, static_cast<uint64_t>(entry.size) | (static_cast<uint64_t>(last ? 1 : 0) << 32));
+    poly.update(trailer, sizeof(trailer));
+    return poly.finish();
+}
+
+// 加密第 index 块（原地），填写索引项
+void encryptChunk(const IKeystream& keystream, const uint8_t* fileNonce, uint64_t index, bool last,
+                  uint8_t* data, uint32_t size, CipherChunkEntry& entry) {
+    entry = CipherChunkEntry{};
+    uint8_t indexBytes[CIPHER_NONCE_SIZE];
+    storeLE64(indexBytes, index);
+    for (int i = 0; i < CIPHER_NONCE_SIZE; ++i) {
+        entry.nonce[i] = fileNonce[i] ^ indexBytes[i];
+    }
+    entry.size = size;
+    keystream.apply(entry.nonce, dataCounter(keystream), data, size);
+    const Poly1305::Tag tag = chunkTag(keystream, entry, index, last, data);
+    std::copy(tag.begin(), tag.end(), entry.tag);
+}
+
+// 校验第 index 块的认证标签，通过后原地解密；标签比较不提前退出
+bool decryptChunk(const IKeystream& keystream, const CipherChunkEntry& entry, uint64_t index, bool last,
+                  uint8_t* data) {
+    const Poly1305::Tag tag = chunkTag(keystream, entry, index, last, data);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < tag.size(); ++i) {
+        diff |= static_cast<uint8_t>(tag[i] ^ entry.tag[i]);
+    }
+    if (diff != 0) return false;
+    keystream.apply(entry.nonce, dataCounter(keystream), data, entry.size);
+    return true;
+}
+
+// 按偏移读写的文件，多个线程可以同时读写不同区域（POSIX 为 pread/pwrite，Windows 为带偏移的 ReadFile/WriteFile）
+class PositionalFile {
+ public:
+    PositionalFile() = default;
+    PositionalFile(const PositionalFile&) = delete;
+    PositionalFile& operator=(const PositionalFile&) = delete;
+    ~PositionalFile() { close(); }
+
+    // 打开文件，forWrite 为 true 时创建或清空文件用于写入
+    bool open(const std::string& path, bool forWrite) {
+#ifdef _WIN32
+        handle = CreateFileW(std::filesystem::path(path).wstring().c_str(),
+                             forWrite ? GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             forWrite ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return handle != INVALID_HANDLE_VALUE;
+#else
+        fd = forWrite ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+        return fd >= 0;
+#endif
+    }
+
+    bool close() {
+        bool ok = true;
+#ifdef _WIN32
+        if (handle != INVALID_HANDLE_VALUE) ok = CloseHandle(handle) != 0;
+        handle = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) ok = ::close(fd) == 0;
+        fd = -1;
+#endif
+        return ok;
+    }
+
+    // 从 offset 处读取 size 字节，读到文件末尾或出错时返回false
+    bool readAt(uint64_t offset, uint8_t* data, size_t size) const {
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD n = 0;
+            if (!ReadFile(handle, data, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &n, &overlapped) || n == 0) {
+                return false;
+            }
+#else
+            ssize_t n = ::pread(fd, data, size, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+#endif
+            data += n;
+            offset += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    // 在 offset 处写入 size 字节
+    bool writeAt(uint64_t offset, const uint8_t* data, size_t size) const {
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD n = 0;
+            if (!WriteFile(handle, data, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &n, &overlapped) || n == 0) {
+                return false;
+            }
+#else
+            ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+#endif
+            data += n;
+            offset += n;
+            size -= n;
+        }
+        return true;
+    }
+
+ private:
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+};
+
+// 单个分块的处理结果
+struct ChunkResult {
+    bool ok;
+    uint32_t crc32;  // 本块明文的CRC32
+    uint32_t size;  // 本块明文大小
+};
+
+// 处理 count 个分块：多线程时在线程池上并行执行 task(i)，各块自行按偏移读写文件；
+// 主线程按顺序收集结果并合并各块CRC，在途分块数有上限以限制内存，任一分块失败后不再提交新的分块
+template <typename Task>
+bool processChunks(uint64_t count, size_t threadCount, Task task, uint32_t& crc32) {
+    const size_t threads = std::max<size_t>(1, std::min<uint64_t>(
+        threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount, count));
+    crc32 = 0;  // 空数据的CRC32
+    if (threads == 1) {
+        for (uint64_t i = 0; i < count; ++i) {
+            const ChunkResult result = task(i);
+            if (!result.ok) return false;
+            crc32 = CRC32::combine(crc32, result.crc32, result.size);
+        }
+        return true;
+    }
+
+    ThreadPool pool(threads);
+    const size_t maxPending = threads * 2;
+    std::deque<std::future<ChunkResult>> pending;
+    bool ok = true;
+    auto collectFront = [&]() {
+        const ChunkResult result = pending.front().get();
+        pending.pop_front();
+        if (!result.ok) {
+            ok = false;
+        } else if (ok) {
+            crc32 = CRC32::combine(crc32, result.crc32, result.size);
+        }
+    };
+    for (uint64_t i = 0; i < count && ok; ++i) {
+        pending.push_back(pool.submit([&task, i]() { return task(i); }));
+        if (pending.size() >= maxPending) collectFront();
+    }
+    // 已提交的分块仍引用 task，必须全部完成后才能返回
+    while (!pending.empty()) collectFront();
+    return ok;
+}
+
+// 出错时关闭并删除不完整的输出文件
+template <typename File>
+void discardOutput(File& file, const std::string& path) {
+    file.close();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+}  // namespace
+
+std::string CipherEncrypt::encryptFile(const std::string& sourcePath, const std::string& key) {
+    // 首先检查文件是否存在
+    if (!std::filesystem::exists(sourcePath)) {
+        std::cerr << "Error: File " << sourcePath << " does not exist." << std::endl;
+        return "";
+    }
+
+    // 设置加密后路径
+    std::string destPath = sourcePath + ".enc";
+
+    PositionalFile inFile;
+    if (!inFile.open(sourcePath, false)) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading." << std::endl;
+        return "";
+    }
+
+    PositionalFile outFile;
+    if (!outFile.open(destPath, true)) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing." << std::endl;
+        return "";
+    }
+
+    // 生成随机盐和 nonce，每次加密都不同，相同密码加密同一文件也得到不同的密文
+    CipherEncHead head{};
+    head.isEncrypt = 0x31;
+    head.encryptType = getEncryptType();
+    head.version = CIPHER_FORMAT_VERSION;
+    head.headerSize = sizeof(CipherEncHead);
+    head.crc32 = 0;  // 后续计算
+    head.iterations = CIPHER_KDF_ITERATIONS;
+    std::random_device rd;
+    for (uint8_t& b : head.salt) b = static_cast<uint8_t>(rd());
+    for (uint8_t& b : head.nonce) b = static_cast<uint8_t>(rd());
+
+    // 分块数量由源文件大小决定，每块的密文位置固定，各块可以独立加密并直接写到各自的位置
+    CipherChunkHead chunkHead{};
+    chunkHead.chunkSize = CIPHER_CHUNK_SIZE;
+    chunkHead.originalSize = std::filesystem::file_size(sourcePath);
+    chunkHead.chunkCount = (chunkHead.originalSize + CIPHER_CHUNK_SIZE - 1) / CIPHER_CHUNK_SIZE;
+    std::vector<CipherChunkEntry> entries(chunkHead.chunkCount);
+    const uint64_t dataOffset = sizeof(CipherEncHead) + sizeof(CipherChunkHead) +
+                                chunkHead.chunkCount * sizeof(CipherChunkEntry);
+
+    const std::unique_ptr<IKeystream> keystream = createKeystream(deriveKey(key, head).data());
+    auto encryptTask = [&](uint64_t i) {
+        ChunkResult result{false, 0, 0};
+        result.size = static_cast<uint32_t>(
+            std::min<uint64_t>(CIPHER_CHUNK_SIZE, chunkHead.originalSize - i * CIPHER_CHUNK_SIZE));
+        std::vector<uint8_t> buffer(result.size);
+        if (!inFile.readAt(i * CIPHER_CHUNK_SIZE, buffer.data(), buffer.size())) {
+            std::cerr << "Error: Failed to read file " << sourcePath << " (file changed during encryption?)."
+                      << std::endl;
+            return result;
+        }
+        result.crc32 = CRC32::finalize(CRC32::update(CRC32::getInitialValue(), buffer.data(), buffer.size()));
+        encryptChunk(*keystream, head.nonce, i, i + 1 == chunkHead.chunkCount, buffer.data(), result.size,
+                     entries[i]);
+        if (!outFile.writeAt(dataOffset + i * CIPHER_CHUNK_SIZE, buffer.data(), buffer.size())) {
+            std::cerr << "Error: Failed to write file " << destPath << "." << std::endl;
+            return result;
+        }
+        result.ok = true;
+        return result;
+    };
+    if (!processChunks(chunkHead.chunkCount, threadCount, encryptTask, head.crc32)) {
+        discardOutput(outFile, destPath);
+        return "";
+    }
+
+    // 最后写入文件头和分块索引（空文件没有分块，索引为空）
+    std::vector<uint8_t> index;
+    index.reserve(dataOffset);
+    auto append = [&index](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        index.insert(index.end(), bytes, bytes + size);
+    };
+    append(&head, sizeof(CipherEncHead));
+    append(&chunkHead, sizeof(CipherChunkHead));
+    if (!entries.empty()) {
+        append(entries.data(), entries.size() * sizeof(CipherChunkEntry));
+    }
+    if (!outFile.writeAt(0, index.data(), index.size()) || !outFile.close()) {
+        std::cerr << "Error: Failed to write file " << destPath << "." << std::endl;
+        discardOutput(outFile, destPath);
+        return "";
+    }
+
+    return destPath;
+}
+
+bool CipherEncrypt::readHeader(std::ifstream& in, const std::string& sourcePath, CipherEncHead& head) const {
+    in.read(reinterpret_cast<char*>(&head), sizeof(CipherEncHead));
+    if (!in.good()) {
+        std::cerr << "Error: Failed to read header from file " << sourcePath << "." << std::endl;
+        return false;
+    }
+
+    // 检查是否为当前算法的加密文件
+    if (head.isEncrypt != 0x31 || head.encryptType != getEncryptType()) {
+        std::cerr << "Error: File " << sourcePath << " is not encrypted with " << getEncryptTypeName() << "." << std::endl;
+        return false;
+    }
+    if (head.version < static_cast<uint16_t>(CipherFormat::Stream) || head.version > CIPHER_FORMAT_VERSION) {
+        std::cerr << "Error: Unsupported encrypted file version " << head.version << "." << std::endl;
+        return false;
+    }
+    if (head.headerSize < sizeof(CipherEncHead) || head.iterations == 0 || head.iterations > CIPHER_MAX_KDF_ITERATIONS) {
+        std::cerr << "Error: Invalid encrypted file header in " << sourcePath << "." << std::endl;
+        return false;
+    }
+    // 跳过后续版本可能追加的头字段
+    in.seekg(head.headerSize, std::ios::beg);
+    return true;
+}
+
+bool CipherEncrypt::readChunkIndex(std::ifstream& in, const std::string& sourcePath, const CipherEncHead& head,
+                                   CipherChunkHead& chunkHead, std::vector<CipherChunkEntry>& entries) {
+    in.read(reinterpret_cast<char*>(&chunkHead), sizeof(CipherChunkHead));
+    if (!in.good()) {
+        std::cerr << "Error: Failed to read chunk header from file " << sourcePath << "." << std::endl;
+        return false;
+    }
+    // 分块数量必须与明文大小一致，且索引与密文不能超出文件，避免损坏的头导致巨大的内存分配
+    const uint64_t fileSize = std::filesystem::file_size(sourcePath);
+    const uint64_t indexOffset = static_cast<uint64_t>(head.headerSize) + sizeof(CipherChunkHead);
+    if (chunkHead.chunkSize == 0 || chunkHead.chunkSize > CIPHER_MAX_CHUNK_SIZE || chunkHead.originalSize > fileSize ||
+        chunkHead.chunkCount != (chunkHead.originalSize + chunkHead.chunkSize - 1) / chunkHead.chunkSize ||
+        chunkHead.chunkCount > (fileSize - std::min(fileSize, indexOffset)) / sizeof(CipherChunkEntry) ||
+        indexOffset + chunkHead.chunkCount * sizeof(CipherChunkEntry) + chunkHead.originalSize != fileSize) {
+        std::cerr << "Error: Invalid chunk index in file " << sourcePath << "." << std::endl;
+        return false;
+    }
+
+    entries.resize(chunkHead.chunkCount);
+    in.read(reinterpret_cast<char*>(entries.data()),
+            static_cast<std::streamsize>(entries.size() * sizeof(CipherChunkEntry)));
+    if (!in.good()) {
+        std::cerr << "Error: Failed to read chunk index from file " << sourcePath << "." << std::endl;
+        return false;
+    }
+    for (uint64_t i = 0; i < chunkHead.chunkCount; ++i) {
+        const uint64_t expected = std::min<uint64_t>(chunkHead.chunkSize, chunkHead.originalSize - i * chunkHead.chunkSize);
+        if (entries[i].size != expected) {
+            std::cerr << "Error: Invalid chunk index in file " << sourcePath << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CipherEncrypt::decryptFile(const std::string& sourcePath, const std::string& destPath, const std::string& key) {
+    // 首先检查文件是否存在
+    if (!std::filesystem::exists(sourcePath)) {
+        std::cerr << "Error: File " << sourcePath << " does not exist." << std::endl;
+        return false;
+    }
+
+    std::ifstream inFile(sourcePath, std::ios::binary);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading." << std::endl;
+        return false;
+    }
+
+    // 读取头信息
+    CipherEncHead head;
+    if (!readHeader(inFile, sourcePath, head)) {
+        return false;
+    }
+
+    if (head.version == static_cast<uint16_t>(CipherFormat::Chunked)) {
+        return decryptChunked(inFile, sourcePath, destPath, head, key);
+    }
+
+    std::ofstream outFile(destPath, std::ios::binary);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing." << std::endl;
+        return false;
+    }
+
+    // 出错时删除输出文件，其中是未通过校验的明文
+    if (!decryptStream(inFile, outFile, head, key)) {
+        discardOutput(outFile, destPath);
+        return false;
+    }
+
+    inFile.close();
+    outFile.close();
+
+    return true;
+}
+
+bool CipherEncrypt::decryptStream(std::ifstream& in, std::ofstream& out, const CipherEncHead& head,
+                                  const std::string& key) const {
+    const std::unique_ptr<IKeystream> keystream = createKeystream(deriveKey(key, head).data());
+    std::vector<uint8_t> buffer(CIPHER_BUFFER_SIZE);
+    uint32_t crc32 = CRC32::getInitialValue();
+    uint64_t counter = 0;
+    size_t bytesRead;
+    while ((bytesRead = in.read(reinterpret_cast<char*>(buffer.data()), CIPHER_BUFFER_SIZE).gcount()) > 0) {
+        // 先解密，再对整块明文计算crc32
+        keystream->apply(head.nonce, counter, buffer.data(), bytesRead);
+        counter += bytesRead / keystream->blockSize();
+        crc32 = CRC32::update(crc32, buffer.data(), bytesRead);
+        out.write(reinterpret_cast<const char*>(buffer.data()), bytesRead);
+    }
+
+    // 密码错误或数据损坏时明文CRC不一致
+    if (CRC32::finalize(crc32) != head.crc32) {
+        std::cerr << "Error: CRC32 checksum mismatch. Wrong key or file corrupted." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CipherEncrypt::decryptChunked(std::ifstream& in, const std::string& sourcePath, const std::string& destPath,
+                                   const CipherEncHead& head, const std::string& key) const {
+    CipherChunkHead chunkHead;
+    std::vector<CipherChunkEntry> entries;
+    if (!readChunkIndex(in, sourcePath, head, chunkHead, entries)) {
+        return false;
+    }
+    const uint64_t dataOffset = static_cast<uint64_t>(in.tellg());
+
+    PositionalFile inFile;
+    if (!inFile.open(sourcePath, false)) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading." << std::endl;
+        return false;
+    }
+    PositionalFile outFile;
+    if (!outFile.open(destPath, true)) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing." << std::endl;
+        return false;
+    }
+
+    const std::unique_ptr<IKeystream> keystream = createKeystream(deriveKey(key, head).data());
+    auto decryptTask = [&](uint64_t i) {
+        const CipherChunkEntry& entry = entries[i];
+        ChunkResult result{false, 0, entry.size};
+        std::vector<uint8_t> buffer(entry.size);
+        if (!inFile.readAt(dataOffset + i * chunkHead.chunkSize, buffer.data(), buffer.size())) {
+            std::cerr << "Error: Failed to read chunk " << i << " from file " << sourcePath << "." << std::endl;
+            return result;
+        }
+        // 先认证再解密，出错时不输出未经认证的明文
+        if (!decryptChunk(*keystream, entry, i, i + 1 == chunkHead.chunkCount, buffer.data())) {
+            std::cerr << "Error: Authentication failed for chunk " << i << " of file " << sourcePath
+                      << ". Wrong key or file corrupted." << std::endl;
+            return result;
+        }
+        result.crc32 = CRC32::finalize(CRC32::update(CRC32::getInitialValue(), buffer.data(), buffer.size()));
+        if (!outFile.writeAt(i * chunkHead.chunkSize, buffer.data(), buffer.size())) {
+            std::cerr << "Error: Failed to write file " << destPath << "." << std::endl;
+            return result;
+        }
+        result.ok = true;
+        return result;
+    };
+    uint32_t crc32;
+    if (!processChunks(chunkHead.chunkCount, threadCount, decryptTask, crc32)) {
+        discardOutput(outFile, destPath);
+        return false;
+    }
+    if (!outFile.close()) {
+        std::cerr << "Error: Failed to write file " << destPath << "." << std::endl;
+        discardOutput(outFile, destPath);
+        return false;
+    }
+
+    if (crc32 != head.crc32) {
+        std::cerr << "Error: CRC32 checksum mismatch. File may be corrupted." << std::endl;
+        discardOutput(outFile, destPath);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<CipherReader> CipherEncrypt::openReader(const std::string& sourcePath, const std::string& key) const {
+    if (!std::filesystem::exists(sourcePath)) {
+        std::cerr << "Error: File " << sourcePath << " does not exist." << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<CipherReader> reader(new CipherReader());
+    reader->in.open(sourcePath, std::ios::binary);
+    if (!reader->in.is_open()) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading." << std::endl;
+        return nullptr;
+    }
+
+    CipherEncHead head;
+    if (!readHeader(reader->in, sourcePath, head)) {
+        return nullptr;
+    }
+    if (head.version != static_cast<uint16_t>(CipherFormat::Chunked)) {
+        std::cerr << "Error: File " << sourcePath << " is not in the chunked format and cannot be read randomly."
+                  << std::endl;
+        return nullptr;
+    }
+    if (!readChunkIndex(reader->in, sourcePath, head, reader->chunkHead, reader->entries)) {
+        return nullptr;
+    }
+
+    reader->path = sourcePath;
+    reader->dataOffset = static_cast<uint64_t>(reader->in.tellg());
+    reader->keystream = createKeystream(deriveKey(key, head).data());
+    return reader;
+}
+
+bool CipherReader::loadChunk(uint64_t index) {
+    if (index == chunkIndex) return true;
+    const CipherChunkEntry& entry = entries[index];
+    chunk.resize(entry.size);
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(dataOffset + index * chunkHead.chunkSize), std::ios::beg);
+    in.read(reinterpret_cast<char*>(chunk.data()), entry.size);
+    if (static_cast<uint32_t>(in.gcount()) != entry.size) {
+        std::cerr << "Error: Failed to read chunk " << index << " from file " << path << "." << std::endl;
+        chunkIndex = UINT64_MAX;
+        return false;
+    }
+    if (!decryptChunk(*keystream, entry, index, index + 1 == chunkHead.chunkCount, chunk.data())) {
+        std::cerr << "Error: Authentication failed for chunk " << index << " of file " << path
+                  << ". Wrong key or file corrupted." << std::endl;
+        chunkIndex = UINT64_MAX;
+        return false;
+    }
+    chunkIndex = index;
+    return true;
+}
+
+bool CipherReader::read(uint64_t offset, uint8_t* out, size_t size) {
+    if (offset > chunkHead.originalSize || size > chunkHead.originalSize - offset) {
+        std::cerr << "Error: Read beyond the end of file " << path << "." << std::endl;
+        return false;
+    }
+    while (size > 0) {
+        const uint64_t index = offset / chunkHead.chunkSize;
+        if (!loadChunk(index)) return false;
+        const size_t begin = static_cast<size_t>(offset - index * chunkHead.chunkSize);
+        const size_t n = std::min(size, chunk.size() - begin);
+        std::memcpy(out, chunk.data() + begin, n);
+        out += n;
+        offset += n;
+        size -= n;
+    }
+    return true;
+}
@@ -7,6 +7,12 @@ CompressType CompressFactory::stringToCompressType(const std::string& compressTy
     if (compressType == "Huffman") {
         return CompressType::Huffman;
     }
+    if (compressType == "LZ77") {
+        return CompressType::LZ77;
+    }
+    if (compressType == "FSE") {
+        return CompressType::FSE;
+    }
     // 后续继续补充
     throw std::runtime_error("Unknown compress type: " + compressType);
 }
@@ -16,6 +22,12 @@ std::string CompressFactory::compressTypeToString(CompressType compressType) {
     if (compressType == CompressType::Huffman) {
         return "Huffman";
     }
+    if (compressType == CompressType::LZ77) {
+        return "LZ77";
+    }
+    if (compressType == CompressType::FSE) {
+        return "FSE";
+    }
     // 后续继续补充
     throw std::runtime_error("Unknown compress type");
 }
@@ -29,6 +41,10 @@ std::unique_ptr<ICompress> CompressFactory::createCompress(const std::string& co
     switch (type) {
         case CompressType::Huffman:
             return std::make_unique<HuffmanCompress>();
+        case CompressType::LZ77:
+            return std::make_unique<LZ77Compress>();
+        case CompressType::FSE:
+            return std::make_unique<FSECompress>();
         default:
             throw std::runtime_error("Unknown compress type: " + compressType);
     }
@@ -38,7 +54,7 @@ std::unique_ptr<ICompress> CompressFactory::createCompress(const std::string& co
 
 std::vector<std::string> CompressFactory::getSupportedCompressTypes() {
     // 后续继续补充
-    return {"Huffman"};
+    return {"Huffman", "LZ77", "FSE"};
 }
 
 
@@ -0,0 +1,241 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "CopyEngine.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+
+namespace {
+
+// 单次系统调用复制的最大字节数，避免超出 ssize_t / int 的范围
+constexpr uint64_t kMaxCopyPerCall = 1u << 30;
+
+// 内核或文件系统不支持该复制方式时的错误码，其余错误码是真正的读写错误
+bool isUnsupportedError(int error) {
+    return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP || error == ENOTSUP;
+}
+
+int openForRead(const std::filesystem::path& path) {
+#ifdef _WIN32
+    return _wopen(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+int closeFd(int fd) {
+#ifdef _WIN32
+    return _close(fd);
+#else
+    return ::close(fd);
+#endif
+}
+
+// 按偏移读取，返回读到的字节数（0 表示文件结束），出错时返回-1；Windows 没有 pread，先定位再读取
+int64_t readAt(int fd, uint64_t offset, char* data, size_t size) {
+#ifdef _WIN32
+    if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0) return -1;
+    return _read(fd, data, static_cast<unsigned>(size));
+#else
+    ssize_t n;
+    do {
+        n = ::pread(fd, data, size, static_cast<off_t>(offset));
+    } while (n < 0 && errno == EINTR);
+    return n;
+#endif
+}
+
+// 按偏移写入全部数据
+bool writeAt(int fd, uint64_t offset, const char* data, size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0) return false;
+        int64_t n = _write(fd, data, static_cast<unsigned>(std::min<size_t>(size, kMaxCopyPerCall)));
+#else
+        ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return false;
+        data += n;
+        offset += n;
+        size -= n;
+    }
+    return true;
+}
+
+}  // namespace
+
+CopyEngine::~CopyEngine() {
+    close();
+}
+
+bool CopyEngine::open(const std::filesystem::path& destPath) {
+    close();
+#ifdef _WIN32
+    fd = _wopen(destPath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(destPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    empty = true;
+    if (fd < 0) {
+        std::cerr << "Error: Failed to open file " << destPath.string() << " for writing.\n";
+        return false;
+    }
+    return true;
+}
+
+bool CopyEngine::write(uint64_t offset, const void* data, size_t size) {
+    if (!writeAt(fd, offset, static_cast<const char*>(data), size)) {
+        std::cerr << "Error: Failed to write to destination file.\n";
+        return false;
+    }
+    empty = empty && size == 0;
+    return true;
+}
+
+bool CopyEngine::copy(const std::filesystem::path& srcPath, uint64_t offset, uint64_t size) {
+    int srcFd = openForRead(srcPath);
+    if (srcFd < 0) {
+        std::cerr << "Error: Failed to open file " << srcPath.string() << " for reading.\n";
+        return false;
+    }
+
+    uint64_t done = 0;
+    CopyStatus status = CopyStatus::Unsupported;
+#ifdef __linux__
+    // 整个源文件复制到空的目标文件开头时可以直接克隆，目标文件随之与源文件等长
+    std::error_code ec;
+    if (!reflinkDisabled && empty && offset == 0 && size > 0 && std::filesystem::file_size(srcPath, ec) == size) {
+        if (ioctl(fd, FICLONE, srcFd) == 0) {
+            lastMethod = CopyMethod::Reflink;
+            done = size;
+            status = CopyStatus::Finished;
+        } else {
+            reflinkDisabled = true;
+        }
+    }
+    if (status == CopyStatus::Unsupported && !copyFileRangeDisabled) {
+        lastMethod = CopyMethod::CopyFileRange;
+        status = copyFileRange(srcFd, offset, size, done);
+    }
+    if (status == CopyStatus::Unsupported && !sendfileDisabled) {
+        lastMethod = CopyMethod::Sendfile;
+        status = copySendfile(srcFd, offset, size, done);
+    }
+#endif
+    if (status == CopyStatus::Unsupported) {
+        lastMethod = CopyMethod::Buffered;
+        status = copyBuffered(srcFd, offset, size, done);
+    }
+    closeFd(srcFd);
+
+    if (status != CopyStatus::Finished) {
+        std::cerr << "Error: Failed to copy file " << srcPath.string() << " (" << std::strerror(lastError) << ").\n";
+        return false;
+    }
+    if (done != size) {
+        std::cerr << "Error: Unexpected end of file while reading " << srcPath.string()
+        << " (" << done << " of " << size << " bytes).\n";
+        return false;
+    }
+    empty = empty && size == 0;
+    return true;
+}
+
+CopyEngine::CopyStatus CopyEngine::copyFileRange(int srcFd, uint64_t offset, uint64_t size, uint64_t& done) {
+#ifdef __linux__
+    while (done < size) {
+        loff_t inOffset = static_cast<loff_t>(done);
+        loff_t outOffset = static_cast<loff_t>(offset + done);
+        ssize_t n = copy_file_range(srcFd, &inOffset, fd, &outOffset,
+                                    static_cast<size_t>(std::min(size - done, kMaxCopyPerCall)), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            lastError = errno;
+            if (!isUnsupportedError(lastError)) return CopyStatus::Failed;
+            // ENOSYS（内核过旧）、EXDEV（跨文件系统）、EINVAL/EOPNOTSUPP（文件系统不支持），之后改用下一种方式
+            copyFileRangeDisabled = true;
+            return CopyStatus::Unsupported;
+        }
+        // procfs/sysfs、部分 FUSE 和旧版 overlayfs 对非空文件也返回0，一个字节都没复制时交给下一种方式
+        if (n == 0) return done == 0 ? CopyStatus::Unsupported : CopyStatus::Finished;
+        done += n;
+    }
+    return CopyStatus::Finished;
+#else
+    return CopyStatus::Unsupported;
+#endif
+}
+
+CopyEngine::CopyStatus CopyEngine::copySendfile(int srcFd, uint64_t offset, uint64_t size, uint64_t& done) {
+#ifdef __linux__
+    // sendfile 写到目标文件的当前位置
+    if (lseek(fd, static_cast<off_t>(offset + done), SEEK_SET) < 0) {
+        lastError = errno;
+        return CopyStatus::Failed;
+    }
+    while (done < size) {
+        off_t inOffset = static_cast<off_t>(done);
+        ssize_t n = sendfile(fd, srcFd, &inOffset, static_cast<size_t>(std::min(size - done, kMaxCopyPerCall)));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            lastError = errno;
+            if (!isUnsupportedError(lastError)) return CopyStatus::Failed;
+            sendfileDisabled = true;
+            return CopyStatus::Unsupported;
+        }
+        if (n == 0) return done == 0 ? CopyStatus::Unsupported : CopyStatus::Finished;
+        done += n;
+    }
+    return CopyStatus::Finished;
+#else
+    return CopyStatus::Unsupported;
+#endif
+}
+
+CopyEngine::CopyStatus CopyEngine::copyBuffered(int srcFd, uint64_t offset, uint64_t size, uint64_t& done) {
+    std::vector<char> buffer(static_cast<size_t>(std::min<uint64_t>(COPY_BUFFER_SIZE, size - done)));
+    while (done < size) {
+        size_t toRead = static_cast<size_t>(std::min<uint64_t>(buffer.size(), size - done));
+        int64_t n = readAt(srcFd, done, buffer.data(), toRead);
+        if (n < 0 || (n > 0 && !writeAt(fd, offset + done, buffer.data(), static_cast<size_t>(n)))) {
+            lastError = errno;
+            return CopyStatus::Failed;
+        }
+        if (n == 0) return CopyStatus::Finished;
+        done += n;
+    }
+    return CopyStatus::Finished;
+}
+
+bool CopyEngine::close() {
+    if (fd < 0) return true;
+    bool ok = closeFd(fd) == 0;
+    fd = -1;
+    return ok;
+}
+
+const char* CopyEngine::getMethodName(CopyMethod method) {
+    switch (method) {
+        case CopyMethod::Reflink: return "reflink";
+        case CopyMethod::CopyFileRange: return "copy_file_range";
+        case CopyMethod::Sendfile: return "sendfile";
+        default: return "buffered";
+    }
+}
@@ -0,0 +1,99 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "CpuFeatures.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+
+#if defined(__x86_64__) || defined(_M_X64)
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// 读取 XCR0：操作系统启用了哪些寄存器状态
+uint64_t readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+CpuFeatures detect() {
+    CpuFeatures features;
+#if defined(__x86_64__) || defined(_M_X64)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    const uint32_t maxLeaf = regs[0];
+    cpuid(1, 0, regs);
+    const uint32_t ecx1 = regs[2];
+    features.sse41 = (ecx1 & (1u << 19)) != 0;
+    features.pclmul = (ecx1 & (1u << 1)) != 0;
+    features.aesni = (ecx1 & (1u << 25)) != 0;
+
+    // AVX 需要 OSXSAVE，且操作系统保存 XMM/YMM 状态；AVX-512 另需 opmask/ZMM 状态
+    const bool osxsave = (ecx1 & (1u << 27)) != 0;
+    const bool avx = (ecx1 & (1u << 28)) != 0;
+    const uint64_t xcr0 = osxsave ? readXcr0() : 0;
+    const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+    if (maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        features.avx2 = avx && ymmEnabled && (regs[1] & (1u << 5)) != 0;
+        features.avx512 = avx && zmmEnabled && (regs[1] & (1u << 16)) != 0;
+    }
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    features.neon = true;  // AArch64 必定支持 NEON
+#if defined(__linux__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);  // NOLINT(runtime/int)
+#if defined(HWCAP_CRC32)
+    features.armCrc32 = (hwcap & HWCAP_CRC32) != 0;
+#endif
+#if defined(HWCAP_AES)
+    features.armAes = (hwcap & HWCAP_AES) != 0;
+#endif
+#elif defined(__APPLE__)
+    features.armCrc32 = true;
+    features.armAes = true;
+#else
+#if defined(__ARM_FEATURE_CRC32)
+    features.armCrc32 = true;
+#endif
+#if defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+    features.armAes = true;
+#endif
+#endif
+#endif
+    return features;
+}
+
+}  // namespace
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures features = detect();
+    return features;
+}
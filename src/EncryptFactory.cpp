@@ -7,9 +7,12 @@ EncryptType EncryptFactory::stringToEncryptType(const std::string& encryptType)
     if (encryptType == "SimXOR") {
         return EncryptType::SimXOR;
     }
-    // else if(){
-
-    // }
+    if (encryptType == "AES") {
+        return EncryptType::AES;
+    }
+    if (encryptType == "ChaCha20") {
+        return EncryptType::ChaCha20;
+    }
     return EncryptType::None;
 }
 
@@ -19,6 +22,10 @@ std::string EncryptFactory::encryptTypeToString(EncryptType encryptType) {
     switch (encryptType) {
         case EncryptType::SimXOR:
             return "SimXOR";
+        case EncryptType::AES:
+            return "AES";
+        case EncryptType::ChaCha20:
+            return "ChaCha20";
         default:
             return "None";
     }
@@ -32,6 +39,10 @@ std::unique_ptr<IEncrypt> EncryptFactory::createEncryptor(const std::string& enc
     switch (entype) {
         case EncryptType::SimXOR:
             return std::make_unique<SimpleXOREncrypt>();
+        case EncryptType::AES:
+            return std::make_unique<AESEncrypt>();
+        case EncryptType::ChaCha20:
+            return std::make_unique<ChaCha20Encrypt>();
         default:
             std::cerr << "Error: Unknown encrypt type." << std::endl;
             return nullptr;
@@ -41,7 +52,7 @@ std::unique_ptr<IEncrypt> EncryptFactory::createEncryptor(const std::string& enc
 // 获取支持的加密类型
 std::vector<std::string> EncryptFactory::getSupportedEncryptTypes() {
     // 但是这样每次都要维护，有没有更为高效的方案
-    return {"SimXOR"};
+    return {"SimXOR", "AES", "ChaCha20"};
 }
 
 
@@ -0,0 +1,522 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "FSECompress.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+// 最高位的位置（v > 0）
+static inline int highBit(uint32_t v) {
+    int n = 0;
+    while (v >>= 1) ++n;
+    return n;
+}
+
+static inline uint32_t load32LE(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/*
+ * 位写入器：低位先写，满32位整字写出；结束时写入一个1作为结束标记，
+ * 解码器据此从最后一个字节找到位流的末尾
+*/
+class FSEBitWriter {
+ public:
+    explicit FSEBitWriter(uint8_t* dst) : begin(dst), cur(dst) {}
+
+    void write(uint32_t value, int bits) {
+        bitBuf |= static_cast<uint64_t>(value & ((1u << bits) - 1)) << bitCount;
+        bitCount += bits;
+        if (bitCount >= 32) {
+            uint32_t word = static_cast<uint32_t>(bitBuf);
+            cur[0] = static_cast<uint8_t>(word);
+            cur[1] = static_cast<uint8_t>(word >> 8);
+            cur[2] = static_cast<uint8_t>(word >> 16);
+            cur[3] = static_cast<uint8_t>(word >> 24);
+            cur += 4;
+            bitBuf >>= 32;
+            bitCount -= 32;
+        }
+    }
+
+    // 写入结束标记和剩余的位，返回写入的总字节数
+    size_t finish() {
+        write(1, 1);
+        while (bitCount > 0) {
+            *cur++ = static_cast<uint8_t>(bitBuf);
+            bitBuf >>= 8;
+            bitCount = bitCount > 8 ? bitCount - 8 : 0;
+        }
+        return static_cast<size_t>(cur - begin);
+    }
+
+ private:
+    uint8_t* begin;
+    uint8_t* cur;
+    uint64_t bitBuf = 0;
+    int bitCount = 0;
+};
+
+// 位读取器：从位流末尾向前读取，与 FSEBitWriter 的写入顺序相反
+class FSEBitReader {
+ public:
+    FSEBitReader(const uint8_t* data, size_t size) : data(data), size(size) {
+        if (size == 0 || data[size - 1] == 0) {
+            bitPos = -1;  // 没有结束标记
+            return;
+        }
+        bitPos = static_cast<int64_t>(size - 1) * 8 + highBit(data[size - 1]);
+    }
+
+    uint32_t read(int bits) {
+        bitPos -= bits;
+        if (bitPos < 0) {
+            overflow = true;
+            bitPos = 0;
+            return 0;
+        }
+        size_t index = static_cast<size_t>(bitPos >> 3);
+        uint32_t v;
+        if (index + 4 <= size) {
+            v = load32LE(data + index);
+        } else {
+            uint8_t tail[4] = {0, 0, 0, 0};
+            std::memcpy(tail, data + index, size - index);
+            v = load32LE(tail);
+        }
+        return (v >> (bitPos & 7)) & ((1u << bits) - 1);
+    }
+
+    // 位流是否恰好读完
+    bool finished() const { return !overflow && bitPos == 0; }
+    bool valid() const { return bitPos >= 0; }
+
+ private:
+    const uint8_t* data;
+    size_t size;
+    int64_t bitPos;  // 尚未读取的位数
+    bool overflow = false;
+};
+
+// 把符号分散到状态表中，编码器和解码器必须使用相同的分布
+static void spreadSymbols(const std::array<uint16_t, 256>& norm, int maxSymbol, int tableLog,
+                          std::vector<uint8_t>& tableSymbol) {
+    const uint32_t tableSize = 1u << tableLog;
+    const uint32_t mask = tableSize - 1;
+    const uint32_t step = (tableSize >> 1) + (tableSize >> 3) + 3;  // 奇数，与状态表大小互质
+    tableSymbol.assign(tableSize, 0);
+    uint32_t pos = 0;
+    for (int s = 0; s <= maxSymbol; ++s) {
+        for (uint32_t i = 0; i < norm[s]; ++i) {
+            tableSymbol[pos] = static_cast<uint8_t>(s);
+            pos = (pos + step) & mask;
+        }
+    }
+}
+
+// 把计数归一化为总和为 2^tableLog 的整数，出现过的符号至少为1，调整时优先选择对压缩率影响最小的符号
+static void normalizeCounts(const std::array<uint32_t, 256>& count, size_t total, int maxSymbol, int tableLog,
+                            std::array<uint16_t, 256>& norm) {
+    const uint32_t tableSize = 1u << tableLog;
+    norm.fill(0);
+    int64_t sum = 0;
+    for (int s = 0; s <= maxSymbol; ++s) {
+        if (count[s] == 0) continue;
+        uint64_t scaled = (static_cast<uint64_t>(count[s]) * tableSize + total / 2) / total;
+        norm[s] = static_cast<uint16_t>(std::max<uint64_t>(scaled, 1));
+        sum += norm[s];
+    }
+    while (sum > tableSize) {
+        // 减1代价 count * log2(norm / (norm - 1)) 最小的符号
+        int best = -1;
+        double bestCost = 0;
+        for (int s = 0; s <= maxSymbol; ++s) {
+            if (norm[s] <= 1) continue;
+            double cost = count[s] * std::log2(static_cast<double>(norm[s]) / (norm[s] - 1));
+            if (best < 0 || cost < bestCost) {
+                best = s;
+                bestCost = cost;
+            }
+        }
+        norm[best]--;
+        sum--;
+    }
+    while (sum < tableSize) {
+        // 加1收益 count * log2((norm + 1) / norm) 最大的符号
+        int best = -1;
+        double bestGain = 0;
+        for (int s = 0; s <= maxSymbol; ++s) {
+            if (count[s] == 0) continue;
+            double gain = count[s] * std::log2(static_cast<double>(norm[s] + 1) / norm[s]);
+            if (best < 0 || gain > bestGain) {
+                best = s;
+                bestGain = gain;
+            }
+        }
+        norm[best]++;
+        sum++;
+    }
+}
+
+size_t FSECompress::compressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& dst, int maxTableLog) {
+    if (size < 2) return 0;
+
+    // 统计词频
+    std::array<uint32_t, 256> count = {0};
+    for (size_t i = 0; i < size; ++i) {
+        ++count[src[i]];
+    }
+    int maxSymbol = 255;
+    while (count[maxSymbol] == 0) --maxSymbol;
+    int distinct = 0;
+    for (int s = 0; s <= maxSymbol; ++s) {
+        if (count[s] != 0) ++distinct;
+    }
+    if (distinct < 2) return 0;
+
+    // 状态表大小：数据量小时缩小状态表，但要保证每个符号至少能分到一个状态
+    int tableLog = std::min(std::max(maxTableLog, FSE_MIN_TABLE_LOG), FSE_MAX_TABLE_LOG);
+    while (tableLog > FSE_MIN_TABLE_LOG && (size_t{1} << (tableLog - 1)) >= size) --tableLog;
+    while ((1 << tableLog) < distinct * 2 && tableLog < FSE_MAX_TABLE_LOG) ++tableLog;
+    const uint32_t tableSize = 1u << tableLog;
+
+    std::array<uint16_t, 256> norm;
+    normalizeCounts(count, size, maxSymbol, tableLog, norm);
+
+    // 估算编码大小，不能明显变小时不编码
+    const size_t headerSize = 2 + 2 * static_cast<size_t>(maxSymbol + 1);
+    double bits = 0;
+    for (int s = 0; s <= maxSymbol; ++s) {
+        if (count[s] != 0) bits += count[s] * (tableLog - std::log2(static_cast<double>(norm[s])));
+    }
+    if (headerSize + static_cast<size_t>(bits / 8) + size / FSE_STORE_THRESHOLD >= size) return 0;
+
+    // 编码表：stateTable 为每个符号排好序的下一个状态，symbolTT 为符号的状态变换参数
+    std::vector<uint8_t> tableSymbol;
+    spreadSymbols(norm, maxSymbol, tableLog, tableSymbol);
+    std::array<uint32_t, 257> cumul;
+    cumul[0] = 0;
+    for (int s = 0; s <= maxSymbol; ++s) cumul[s + 1] = cumul[s] + norm[s];
+    std::vector<uint16_t> stateTable(tableSize);
+    {
+        std::array<uint32_t, 257> next = cumul;
+        for (uint32_t u = 0; u < tableSize; ++u) {
+            stateTable[next[tableSymbol[u]]++] = static_cast<uint16_t>(tableSize + u);
+        }
+    }
+    struct SymbolTransform {
+        int32_t deltaFindState;
+        uint32_t deltaNbBits;
+    };
+    std::array<SymbolTransform, 256> symbolTT{};
+    for (int s = 0; s <= maxSymbol; ++s) {
+        if (norm[s] == 0) continue;
+        if (norm[s] == 1) {
+            symbolTT[s].deltaNbBits = (static_cast<uint32_t>(tableLog) << 16) - tableSize;
+            symbolTT[s].deltaFindState = static_cast<int32_t>(cumul[s]) - 1;
+        } else {
+            const uint32_t maxBitsOut = tableLog - highBit(norm[s] - 1u);
+            const uint32_t minStatePlus = static_cast<uint32_t>(norm[s]) << maxBitsOut;
+            symbolTT[s].deltaNbBits = (maxBitsOut << 16) - minStatePlus;
+            symbolTT[s].deltaFindState = static_cast<int32_t>(cumul[s]) - norm[s];
+        }
+    }
+
+    // 写入块头：状态表位数、最大符号、归一化计数
+    const size_t start = dst.size();
+    dst.resize(start + headerSize + size * tableLog / 8 + 16);
+    uint8_t* out = dst.data() + start;
+    out[0] = static_cast<uint8_t>(tableLog);
+    out[1] = static_cast<uint8_t>(maxSymbol);
+    for (int s = 0; s <= maxSymbol; ++s) {
+        out[2 + 2 * s] = static_cast<uint8_t>(norm[s]);
+        out[3 + 2 * s] = static_cast<uint8_t>(norm[s] >> 8);
+    }
+
+    // 倒序编码：最后一个符号直接确定初始状态，不输出位
+    FSEBitWriter writer(out + headerSize);
+    const SymbolTransform& last = symbolTT[src[size - 1]];
+    uint32_t nbBitsOut = (last.deltaNbBits + (1u << 15)) >> 16;
+    uint32_t state = (nbBitsOut << 16) - last.deltaNbBits;
+    state = stateTable[(state >> nbBitsOut) + last.deltaFindState];
+    for (size_t i = size - 1; i-- > 0;) {
+        const SymbolTransform& tt = symbolTT[src[i]];
+        nbBitsOut = (state + tt.deltaNbBits) >> 16;
+        writer.write(state, static_cast<int>(nbBitsOut));
+        state = stateTable[(state >> nbBitsOut) + tt.deltaFindState];
+    }
+    // 最后写入状态，解码器最先读到
+    writer.write(state, tableLog);
+    dst.resize(start + headerSize + writer.finish());
+    return dst.size() - start;
+}
+
+bool FSECompress::decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+    if (size < 2 || dstSize == 0) return false;
+    const int tableLog = src[0];
+    const int maxSymbol = src[1];
+    const size_t headerSize = 2 + 2 * static_cast<size_t>(maxSymbol + 1);
+    if (tableLog < FSE_MIN_TABLE_LOG || tableLog > FSE_MAX_TABLE_LOG || size <= headerSize) return false;
+    const uint32_t tableSize = 1u << tableLog;
+
+    // 读取归一化计数并校验总和
+    std::array<uint16_t, 256> norm{};
+    uint32_t sum = 0;
+    for (int s = 0; s <= maxSymbol; ++s) {
+        norm[s] = static_cast<uint16_t>(src[2 + 2 * s] | (src[3 + 2 * s] << 8));
+        sum += norm[s];
+        if (sum > tableSize) return false;
+    }
+    if (sum != tableSize) return false;
+
+    // 解码表：每个状态对应的符号、需要读取的位数和下一个状态的基数
+    struct DecodeEntry {
+        uint16_t newState;
+        uint8_t symbol;
+        uint8_t nbBits;
+    };
+    std::vector<uint8_t> tableSymbol;
+    spreadSymbols(norm, maxSymbol, tableLog, tableSymbol);
+    std::vector<DecodeEntry> table(tableSize);
+    std::array<uint32_t, 256> symbolNext;
+    for (int s = 0; s <= maxSymbol; ++s) symbolNext[s] = norm[s];
+    for (uint32_t u = 0; u < tableSize; ++u) {
+        const uint8_t s = tableSymbol[u];
+        const uint32_t nextState = symbolNext[s]++;
+        const int nbBits = tableLog - highBit(nextState);
+        table[u] = DecodeEntry{static_cast<uint16_t>((nextState << nbBits) - tableSize), s,
+                               static_cast<uint8_t>(nbBits)};
+    }
+
+    // 从位流末尾开始解码，每个符号只需一次查表，不需要按符号分支
+    FSEBitReader reader(src + headerSize, size - headerSize);
+    if (!reader.valid()) return false;
+    uint32_t state = reader.read(tableLog);
+    for (size_t i = 0; i + 1 < dstSize; ++i) {
+        const DecodeEntry& entry = table[state];
+        dst[i] = entry.symbol;
+        state = entry.newState + reader.read(entry.nbBits);
+    }
+    dst[dstSize - 1] = table[state].symbol;
+    return reader.finished();
+}
+
+void FSECompress::setCompressionLevel(int newLevel) {
+    level = std::min(std::max(newLevel, COMPRESS_MIN_LEVEL), COMPRESS_MAX_LEVEL);
+}
+
+int FSECompress::maxTableLog() const {
+    if (level <= 3) return FSE_MAX_TABLE_LOG - 2;
+    if (level <= 6) return FSE_MAX_TABLE_LOG - 1;
+    return FSE_MAX_TABLE_LOG;
+}
+
+std::string FSECompress::compressFile(const std::string& sourcePath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in || !in.is_open()) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        return "";
+    }
+
+    // 在原先文件基础上增加后缀即可
+    std::string destPath = sourcePath + ".fse";
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out || !out.is_open()) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        return "";
+    }
+
+    if (!compressStream(in, out)) {
+        std::cerr << "Error: Failed to write file " << destPath << ".\n";
+        out.close();
+        std::error_code ec;
+        fs::remove(destPath, ec);
+        return "";
+    }
+    out.close();
+    in.close();
+    return destPath;
+}
+
+bool FSECompress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    destData.clear();
+    MemoryInputStream in(sourceData.data(), sourceData.size());
+    VectorOutputStream out(destData);
+    if (!compressStream(in, out)) {
+        destData.clear();
+        return false;
+    }
+    return true;
+}
+
+static_assert(FSE_DEFAULT_BLOCK_SIZE <= COMPRESS_MAX_BLOCK_SIZE, "FSE block size exceeds COMPRESS_MAX_BLOCK_SIZE");
+
+bool FSECompress::compressStream(std::istream& in, std::ostream& out) const {
+    // 创建文件头信息，原始大小和CRC在压缩完成后回写
+    FSEHead header{};
+    header.isCompress = 0x21;
+    header.compressType = CompressType::FSE;
+    header.version = FSE_FORMAT_VERSION;
+    header.level = static_cast<uint8_t>(level);
+    header.headerSize = sizeof(FSEHead);
+    header.blockSize = FSE_DEFAULT_BLOCK_SIZE;
+    header.originalSize = 0;
+    header.crc32 = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(FSEHead));
+
+    std::vector<uint8_t> readBuffer(header.blockSize);
+    std::vector<uint8_t> compressed;
+    uint32_t crcValue = CRC32::getInitialValue();
+    const int tableLog = maxTableLog();
+
+    while (in) {
+        in.read(reinterpret_cast<char*>(readBuffer.data()), static_cast<std::streamsize>(readBuffer.size()));
+        std::streamsize n = in.gcount();
+        if (n <= 0) break;
+        crcValue = CRC32::update(crcValue, readBuffer.data(), static_cast<size_t>(n));
+        header.originalSize += static_cast<uint64_t>(n);
+
+        FSEBlockHead blockHead;
+        blockHead.originalSize = static_cast<uint32_t>(n);
+        const bool single = std::all_of(readBuffer.begin() + 1, readBuffer.begin() + n,
+                                        [&](uint8_t b) { return b == readBuffer[0]; });
+        compressed.clear();
+        size_t compressedSize = single ? 0 : compressBlock(readBuffer.data(), static_cast<size_t>(n),
+                                                           compressed, tableLog);
+        if (single) {
+            // 只有一种字节
+            blockHead.compressedSize = 1 | FSE_RLE_BLOCK_FLAG;
+            out.write(reinterpret_cast<const char*>(&blockHead), sizeof(FSEBlockHead));
+            out.write(reinterpret_cast<const char*>(readBuffer.data()), 1);
+        } else if (compressedSize > 0 && compressedSize < static_cast<size_t>(n)) {
+            blockHead.compressedSize = static_cast<uint32_t>(compressedSize);
+            out.write(reinterpret_cast<const char*>(&blockHead), sizeof(FSEBlockHead));
+            out.write(reinterpret_cast<const char*>(compressed.data()), compressedSize);
+        } else {
+            // 不可压缩的块原样存储
+            blockHead.compressedSize = static_cast<uint32_t>(n) | FSE_RAW_BLOCK_FLAG;
+            out.write(reinterpret_cast<const char*>(&blockHead), sizeof(FSEBlockHead));
+            out.write(reinterpret_cast<const char*>(readBuffer.data()), n);
+        }
+    }
+
+    // 回写文件头
+    header.crc32 = CRC32::finalize(crcValue);
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(FSEHead));
+    return static_cast<bool>(out);
+}
+
+bool FSECompress::decompressFile(const std::string& sourcePath, const std::string& destPath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in || !in.is_open()) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        return false;
+    }
+
+    // 读取并校验头信息
+    FSEHead header;
+    if (!readHeader(in, sourcePath, header)) return false;
+
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out || !out.is_open()) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        return false;
+    }
+
+    // 出错时删除不完整的输出文件
+    if (!decodeStream(in, sourcePath, header, out)) {
+        out.close();
+        std::error_code ec;
+        fs::remove(destPath, ec);
+        return false;
+    }
+    out.close();
+    return true;
+}
+
+bool FSECompress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    destData.clear();
+    MemoryInputStream in(sourceData.data(), sourceData.size());
+    FSEHead header;
+    if (!readHeader(in, "memory buffer", header)) return false;
+
+    reserveDecompressOutput(destData, header.originalSize, sourceData.size());
+    VectorOutputStream out(destData);
+    if (!decodeStream(in, "memory buffer", header, out)) {
+        destData.clear();
+        return false;
+    }
+    return true;
+}
+
+bool FSECompress::readHeader(std::istream& in, const std::string& sourceName, FSEHead& header) {
+    in.read(reinterpret_cast<char*>(&header), sizeof(FSEHead));
+    if (!in || header.isCompress != 0x21 || header.compressType != CompressType::FSE ||
+        header.blockSize == 0 || header.blockSize > COMPRESS_MAX_BLOCK_SIZE) {
+        std::cerr << "Error: File " << sourceName << " is not a FSE compressed file.\n";
+        return false;
+    }
+    if (header.version > FSE_FORMAT_VERSION) {
+        std::cerr << "Error: Unsupported FSE format version " << static_cast<int>(header.version)
+                  << " in " << sourceName << ".\n";
+        return false;
+    }
+    return true;
+}
+
+bool FSECompress::decodeStream(std::istream& in, const std::string& sourceName, const FSEHead& header,
+                               std::ostream& out) {
+    auto fail = [](const std::string& message) {
+        std::cerr << "Error: " << message << "\n";
+        return false;
+    };
+
+    std::vector<uint8_t> blockData;
+    std::vector<uint8_t> decompressed(header.blockSize);
+    uint32_t crcValue = CRC32::getInitialValue();
+    uint64_t totalSize = 0;
+
+    // 逐块解压，内存占用只与块大小有关
+    while (totalSize < header.originalSize) {
+        FSEBlockHead blockHead;
+        in.read(reinterpret_cast<char*>(&blockHead), sizeof(FSEBlockHead));
+        const bool raw = (blockHead.compressedSize & FSE_RAW_BLOCK_FLAG) != 0;
+        const bool rle = (blockHead.compressedSize & FSE_RLE_BLOCK_FLAG) != 0;
+        const uint32_t dataSize = blockHead.compressedSize & FSE_BLOCK_SIZE_MASK;
+        if (!in || blockHead.originalSize == 0 || blockHead.originalSize > header.blockSize ||
+            blockHead.originalSize > header.originalSize - totalSize || (raw && rle) ||
+            (raw ? dataSize != blockHead.originalSize : rle ? dataSize != 1 : dataSize >= blockHead.originalSize)) {
+            return fail("Invalid block header in " + sourceName + ".");
+        }
+
+        blockData.resize(dataSize);
+        in.read(reinterpret_cast<char*>(blockData.data()), dataSize);
+        if (!in) {
+            return fail("Unexpected end of compressed data in " + sourceName + ".");
+        }
+
+        const uint8_t* output = decompressed.data();
+        if (raw) {
+            output = blockData.data();
+        } else if (rle) {
+            std::memset(decompressed.data(), blockData[0], blockHead.originalSize);
+        } else if (!decompressBlock(blockData.data(), dataSize, decompressed.data(), blockHead.originalSize)) {
+            return fail("Corrupted block in " + sourceName + ".");
+        }
+
+        crcValue = CRC32::update(crcValue, output, blockHead.originalSize);
+        out.write(reinterpret_cast<const char*>(output), blockHead.originalSize);
+        totalSize += blockHead.originalSize;
+    }
+
+    if (CRC32::finalize(crcValue) != header.crc32) {
+        return fail("CRC32 checksum mismatch. Decompressed data may be corrupted.");
+    }
+    if (!out) {
+        return fail("Failed to write decompressed data of " + sourceName + ".");
+    }
+    return true;
+}
@@ -1,37 +1,14 @@
 // Copyright [2025] <JiJun Lu, Linru Zhou>
 #include "HuffmanCompress.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <utility>
 
 namespace fs = std::filesystem;
 
-bool HuffmanCompress::readFreqTable(const std::string& sourcePath,
-                                    std::array<uint64_t, 256>& freqTable, uint64_t& originalSize) {
-    freqTable.fill(0);
-    originalSize = 0;
-    // 读取文件
-    std::ifstream in(sourcePath, std::ios::binary);
-    if (!in || !in.is_open()) {
-        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
-        return false;
-    }
-
-    // 统计词频
-    std::vector<uint8_t> buffer(BUFF_SIZE);
-    while (in) {
-        // 每次读取一个buffer的大小
-        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(BUFF_SIZE));
-        std::streamsize n = in.gcount();    //  可能没有满一个buffer的空间，需要查看实际读取的字节数
-        if (n <= 0)  break;
-        originalSize += static_cast<uint64_t>(n);
-        // 统计词频
-        for (std::streamsize i = 0; i < n; ++i) {
-            ++freqTable[buffer[i]];
-        }
-    }
-    return true;
-}
-
-
 HNode* HuffmanCompress::buildHuffmanTree(const std::array<uint64_t, 256>& freqTable) {
     // 通过优先队列构造小顶堆
     std::priority_queue<HNode*, std::vector<HNode*>, HNodeCmp> pq;
@@ -94,209 +71,290 @@ std::array<std::vector<bool>, 256> HuffmanCompress::generateHuffmanCodes(HNode*
     return codes;
 }
 
-
-std::string HuffmanCompress::compressFile(const std::string& sourcePath) {
-    // 检查目标文件路径是否可以访问
-    // 直接检查是不是存在不太对，因为还没创建一定不存在
-    // TODO(Linru Zhou): 检查目标文件路径是否可以访问
-
-    // 读取内容统计每个字节的出现频率
-    std::array<uint64_t, 256> freq;
-    uint64_t originalSize = 0;
-    if (!readFreqTable(sourcePath, freq, originalSize)) {
-        std::cerr << "Error: Failed to read frequency table from file " << sourcePath << ".\n";
-        return "";
-    }
-    // 构造哈夫曼树
-    HNode* root = buildHuffmanTree(freq);
-    if (!root) {
-        std::cerr << "Error: Failed to build Huffman tree.\n";
-        return "";
-    }
-
-    // 生成编码表
+std::array<uint8_t, 256> HuffmanCompress::buildCodeLengths(const std::array<uint64_t, 256>& freqTable) {
+    std::array<uint8_t, 256> codeLengths{};
+    // 先由哈夫曼树得到最优码长
+    HNode* root = buildHuffmanTree(freqTable);
     auto codes = generateHuffmanCodes(root);
-    // 释放资源
     deleteHuffmanTree(root);
 
-    // 随后创建文件头，存储CRC offset 压缩算法类型
-    // 在原先文件基础上增加后缀即可
-    std::string destPath = sourcePath + ".huff";
-    std::ofstream out(destPath, std::ios::binary);
-    if (!out|| !out.is_open()) {
-        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
-        return "";
+    // 出现过的符号按词频从高到低排列
+    std::vector<int> symbols;
+    for (int i = 0; i < 256; i++) {
+        if (freqTable[i] > 0) symbols.push_back(i);
+    }
+    std::stable_sort(symbols.begin(), symbols.end(),
+        [&freqTable](int a, int b) { return freqTable[a] > freqTable[b]; });
+
+    // Kraft 不等式：sum(2^(MAX - len)) <= 2^MAX 时码长可以构成前缀码
+    const uint64_t kraftLimit = 1ULL << HUFF_MAX_CODE_LEN;
+    uint64_t kraft = 0;
+    for (int sym : symbols) {
+        size_t len = std::min<size_t>(codes[sym].size(), HUFF_MAX_CODE_LEN);
+        codeLengths[sym] = static_cast<uint8_t>(len);
+        kraft += 1ULL << (HUFF_MAX_CODE_LEN - len);
     }
 
-    // 计算词频表大小
-    uint32_t freqTableSize = 0;
-    for (int i = 0; i < 256; i++) {
-        if (freq[i] > 0) {
-            freqTableSize += 1 + 8;  // 1字节字节值 + 8字节频率
+    // 截断后超出限制：从词频最低的符号开始加长编码
+    while (kraft > kraftLimit) {
+        for (auto it = symbols.rbegin(); it != symbols.rend() && kraft > kraftLimit; ++it) {
+            uint8_t& len = codeLengths[*it];
+            if (len < HUFF_MAX_CODE_LEN) {
+                kraft -= 1ULL << (HUFF_MAX_CODE_LEN - len - 1);
+                len++;
+            }
         }
     }
 
-    // 创建文件头信息
-    Head header;
-    header.isCompress = 0x21;
-    header.compressType = CompressType::Huffman;
-    header.validBits = 0;
-    header.reservedBits = 0;
-    header.headerSize = sizeof(Head);
-    header.freqTableSize = freqTableSize;
-    header.originalSize = originalSize;
-    header.crc32 = 0;  // 先设为0，后续计算
-
-    // 写入文件头
-    out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
+    // 还有富余：从词频最高的符号开始缩短编码
+    for (int sym : symbols) {
+        uint8_t& len = codeLengths[sym];
+        while (len > 1 && kraft + (1ULL << (HUFF_MAX_CODE_LEN - len)) <= kraftLimit) {
+            kraft += 1ULL << (HUFF_MAX_CODE_LEN - len);
+            len--;
+        }
+    }
+    return codeLengths;
+}
 
+bool HuffmanCompress::generateCanonicalCodes(const std::array<uint8_t, 256>& codeLengths,
+                                             std::array<std::vector<bool>, 256>& codes) {
+    // 统计每种码长的符号数量并检查 Kraft 不等式
+    std::array<uint32_t, HUFF_MAX_CODE_LEN + 1> lengthCount{};
+    uint64_t kraft = 0;
+    for (int i = 0; i < 256; i++) {
+        if (codeLengths[i] > HUFF_MAX_CODE_LEN) return false;
+        if (codeLengths[i] == 0) continue;
+        lengthCount[codeLengths[i]]++;
+        kraft += 1ULL << (HUFF_MAX_CODE_LEN - codeLengths[i]);
+    }
+    if (kraft > (1ULL << HUFF_MAX_CODE_LEN)) return false;
+
+    // 每种码长的第一个编码：上一长度的首编码加上其数量后左移一位
+    std::array<uint32_t, HUFF_MAX_CODE_LEN + 1> nextCode{};
+    uint32_t code = 0;
+    for (int len = 1; len <= HUFF_MAX_CODE_LEN; len++) {
+        code = (code + lengthCount[len - 1]) << 1;
+        nextCode[len] = code;
+    }
+    nextCode[0] = 0;
 
+    // 同一码长内按符号值递增依次分配
+    for (int i = 0; i < 256; i++) {
+        codes[i].clear();
+        int len = codeLengths[i];
+        if (len == 0) continue;
+        uint32_t value = nextCode[len]++;
+        for (int bit = len - 1; bit >= 0; bit--) {
+            codes[i].push_back((value >> bit) & 1);
+        }
+    }
+    return true;
+}
 
-    // 之后将词频表内容写入文件头
+HNode* HuffmanCompress::buildTreeFromCodes(const std::array<std::vector<bool>, 256>& codes) {
+    HNode* root = new HNode(0, 0);
     for (int i = 0; i < 256; i++) {
-        if (freq[i] > 0) {
-            out.write(reinterpret_cast<const char*>(&i), 1);
-            out.write(reinterpret_cast<const char*>(&freq[i]), 8);
+        HNode* cur = root;
+        for (bool bit : codes[i]) {
+            HNode*& next = bit ? cur->right : cur->left;
+            if (!next) next = new HNode(0, 0);
+            cur = next;
         }
+        if (cur != root) cur->byte = static_cast<uint8_t>(i);
     }
+    return root;
+}
+
 
-    // 将内容写入文件中
-    // 打开文件
+std::string HuffmanCompress::compressFile(const std::string& sourcePath) {
+    // 按块读取源文件，每块在内存中统计词频并编码，源文件只读取一遍
+    std::error_code ec;
+    uint64_t fileSize = fs::file_size(sourcePath, ec);
     std::ifstream in(sourcePath, std::ios::binary);
-    if (!in || !in.is_open()) {
+    if (ec || !in || !in.is_open()) {
         std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
         return "";
     }
 
-    uint32_t crcValue = 0xFFFFFFFF;
-
-    // 准备buffer（压缩缓冲区）
-    std::vector<uint8_t> readBuffer(BUFF_SIZE);
-    std::vector<uint8_t> writeBuffer(BUFF_SIZE);
-    size_t writePos = 0;
-    uint8_t currentByte = 0;
-    int bitPosition = 0;
-
-
-    // 辅助函数：将当前字节写入输出缓冲区
-    auto flushCurrentByte = [&]() {
-        if (writePos >= writeBuffer.size()) {
-        // 输出缓冲区已满，写入文件
-        out.write(reinterpret_cast<const char*>(writeBuffer.data()), writePos);
-        writePos = 0;
-        }
-        writeBuffer[writePos++] = currentByte;
-        currentByte = 0;
-        bitPosition = 0;
-    };
-
-
-    // 压缩
-    while (in) {
-        // 读取一块数据
-        in.read(reinterpret_cast<char*>(readBuffer.data()), static_cast<std::streamsize>(BUFF_SIZE));
-        std::streamsize n = in.gcount();
-        if (n <= 0)  break;
-
-        // 计算CRC
-        crcValue = std::accumulate(readBuffer.begin(), readBuffer.begin() + n, crcValue,
-            [](uint32_t currentCRC, uint8_t byte) {
-                return CRC32::update(currentCRC, byte);
-            });
-
-        // 压缩数据
-        for (std::streamsize i = 0; i < n; i++) {
-            uint8_t byte = readBuffer[i];
-            const std::vector<bool>& code = codes[byte];
-
-            for (bool bit : code) {
-                // 使用位运算将对应位进行填充
-                currentByte |= (bit << (7 - bitPosition));
-                bitPosition++;
-
-                if (bitPosition == 8) {
-                    // 满了8字节，写入输出缓冲区
-                    flushCurrentByte();
-                }
-            }
-        }
-    }
-    // 有可能最后没满1字节
-    if (bitPosition > 0) {
-        header.validBits = 8 - bitPosition;
-        // 写入最后一个字节
-        flushCurrentByte();
+    // 在原先文件基础上增加后缀即可
+    std::string destPath = sourcePath + ".huff";
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out || !out.is_open()) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        return "";
     }
 
-    // 写入剩余的缓冲区内容
-    if (writePos > 0) {
-        out.write(reinterpret_cast<const char*>(writeBuffer.data()), writePos);
+    if (!compressBlocks(in, fileSize, out)) {
+        std::cerr << "Error: Failed to compress file " << sourcePath << ".\n";
+        // 出错时删除写了一半的压缩文件
+        out.close();
+        fs::remove(destPath, ec);
+        return "";
     }
-
-    header.crc32 = crcValue ^ 0xFFFFFFFF;
-
-    // 回写文件头
-    out.seekp(0, std::ios::beg);
-    out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
     out.close();
     in.close();
     return destPath;
 }
 
+bool HuffmanCompress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    destData.clear();
+    MemoryInputStream in(sourceData.data(), sourceData.size());
+    VectorOutputStream out(destData);
+    if (!compressBlocks(in, sourceData.size(), out)) {
+        destData.clear();
+        return false;
+    }
+    return true;
+}
+
 bool HuffmanCompress::decompressFile(const std::string& sourcePath, const std::string& destPath) {
     // 打开压缩文件
-     std::ifstream in(sourcePath, std::ios::binary);
+    std::ifstream in(sourcePath, std::ios::binary);
     if (!in || !in.is_open()) {
         std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
         return false;
     }
 
-    // 打开目标文件写入
+    // 读取头信息和码表
+    Head header;
+    std::array<std::vector<bool>, 256> codes;
+    HNode* root = nullptr;
+    if (!readHeader(in, sourcePath, header, codes, root)) {
+        in.close();
+        return false;
+    }
+
+    // 打开目标文件写入（头信息校验通过后再创建，避免留下空文件）
     std::ofstream out(destPath, std::ios::binary);
     if (!out || !out.is_open()) {
         std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        deleteHuffmanTree(root);
         in.close();
         return false;
     }
 
-    // 读取头信息
+    bool decoded = decodeStream(in, sourcePath, header, codes, root, out);
+    deleteHuffmanTree(root);
+    in.close();
+    if (!decoded) {
+        discardOutput(out, destPath);
+        return false;
+    }
+    out.close();
+    return true;
+}
+
+bool HuffmanCompress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    destData.clear();
+    MemoryInputStream in(sourceData.data(), sourceData.size());
     Head header;
+    std::array<std::vector<bool>, 256> codes;
+    HNode* root = nullptr;
+    if (!readHeader(in, "memory buffer", header, codes, root)) return false;
+
+    reserveDecompressOutput(destData, header.originalSize, sourceData.size());
+    VectorOutputStream out(destData);
+    bool decoded = decodeStream(in, "memory buffer", header, codes, root, out);
+    deleteHuffmanTree(root);
+    if (!decoded) destData.clear();
+    return decoded;
+}
+
+bool HuffmanCompress::readHeader(std::istream& in, const std::string& sourceName, Head& header,
+                                 std::array<std::vector<bool>, 256>& codes, HNode*& root) const {
     in.read(reinterpret_cast<char*>(&header), sizeof(Head));
 
     // 验证是否位压缩文件或压缩类型
-    if (header.isCompress != 0x21 || header.compressType != CompressType::Huffman) {
-        std::cerr << "Error: File " << sourcePath << " is not a Huffman compressed file.\n";
-        in.close();
-        out.close();
+    if (!in || header.isCompress != 0x21 || header.compressType != CompressType::Huffman) {
+        std::cerr << "Error: File " << sourceName << " is not a Huffman compressed file.\n";
         return false;
     }
 
-    // 读取词频表
-    std::array<uint64_t, 256> freqTable = {0};
-    for (uint32_t i = 0; i < header.freqTableSize;) {
-        uint8_t byte;
-        uint64_t freq;
-        in.read(reinterpret_cast<char*>(&byte), 1);
-        in.read(reinterpret_cast<char*>(&freq), 8);
-        freqTable[byte] = freq;
-        i += 1 + 8;
+    // 根据格式版本读取码表并得到编码
+    root = nullptr;
+    if (header.version == static_cast<uint8_t>(HuffmanFormat::FreqTable)) {
+        // 旧格式：读取词频表并重建 Huffman 树
+        std::array<uint64_t, 256> freqTable = {0};
+        for (uint32_t i = 0; i < header.freqTableSize;) {
+            uint8_t byte;
+            uint64_t freq;
+            in.read(reinterpret_cast<char*>(&byte), 1);
+            in.read(reinterpret_cast<char*>(&freq), 8);
+            freqTable[byte] = freq;
+            i += 1 + 8;
+        }
+        root = buildHuffmanTree(freqTable);
+        if (!root) {
+            std::cerr << "Error: Failed to build Huffman tree.\n";
+            return false;
+        }
+        codes = generateHuffmanCodes(root);
+    } else if (header.version != static_cast<uint8_t>(HuffmanFormat::Blocked)) {
+        std::cerr << "Error: Unsupported Huffman format version " << static_cast<int>(header.version)
+                  << " in " << sourceName << ".\n";
+        return false;
     }
+    return true;
+}
 
-    // 重建 Huffman 树
-    HNode* root = buildHuffmanTree(freqTable);
-    if (!root) {
-        std::cerr << "Error: Failed to build Huffman tree.\n";
-        in.close();
-        out.close();
+bool HuffmanCompress::decodeStream(std::istream& in, const std::string& sourceName, const Head& header,
+                                   const std::array<std::vector<bool>, 256>& codes, HNode* root,
+                                   std::ostream& out) const {
+    // 边解码边写出，输出缓冲区大小固定
+    HuffmanOutputBuffer output(out, BUFF_SIZE);
+
+    // 进行解压，默认查表解码
+    bool decoded = false;
+    if (header.version == static_cast<uint8_t>(HuffmanFormat::Blocked)) {
+        decoded = decompressBlocks(in, header, output);
+    } else if (decodeMode == HuffmanDecodeMode::Table) {
+        HuffmanDecodeTable table;
+        if (!table.build(codes)) {
+            std::cerr << "Error: Failed to build Huffman decode table.\n";
+            return false;
+        }
+        HuffmanBitReader reader(in);
+        decoded = table.decode(reader, header.originalSize, [&output](uint8_t byte) { output.put(byte); });
+    } else {
+        decoded = decodeBitByBit(in, root, header, output);
+    }
+
+    if (!decoded) {
+        std::cerr << "Error: Failed to decode compressed data in " << sourceName << ".\n";
+        return false;
+    }
+    if (!output.flush()) {
+        std::cerr << "Error: Failed to write decompressed data of " << sourceName << ".\n";
         return false;
     }
 
+    // 校验校验码
+    if (output.getCRC() != header.crc32) {
+        std::cerr << "Error: CRC32 checksum mismatch. Decompressed data may be corrupted.\n";
+        return false;
+    }
+    return true;
+}
+
+void HuffmanCompress::discardOutput(std::ofstream& out, const std::string& destPath) const {
+    out.close();
+    std::error_code ec;
+    if (corruptPolicy == CorruptOutputPolicy::Quarantine) {
+        const std::string quarantinePath = destPath + ".corrupt";
+        fs::rename(destPath, quarantinePath, ec);
+        if (!ec) {
+            std::cerr << "Warning: Corrupted output moved to " << quarantinePath << ".\n";
+            return;
+        }
+    }
+    fs::remove(destPath, ec);
+}
+
+bool HuffmanCompress::decodeBitByBit(std::istream& in, HNode* root, const Head& header,
+                                     HuffmanOutputBuffer& output) {
     // 准备一块缓存区
     std::vector<uint8_t> readBuffer(BUFF_SIZE);
-    std::vector<uint8_t> decompressedData;
-    decompressedData.reserve(header.originalSize);
-
-    // 进行解压
     HNode* currentNode = root;
     uint64_t decompressedCount = 0;
 
@@ -327,39 +385,346 @@ bool HuffmanCompress::decompressFile(const std::string& sourcePath, const std::s
                 } else {
                     currentNode = currentNode->left;
                 }
+                // 编码不存在（数据损坏）
+                if (!currentNode) return false;
                 // 到了叶子节点，输出对应字节
                 if (currentNode->isLeaf()) {
-                    decompressedData.push_back(currentNode->byte);
+                    output.put(currentNode->byte);
                     decompressedCount++;
                     currentNode = root;  // 重置节点
                 }
             }
         }
     }
+    return decompressedCount == header.originalSize;
+}
 
-    // 释放资源
-    deleteHuffmanTree(root);
+void HuffmanCompress::packCodeLengths(const std::array<uint8_t, 256>& codeLengths, uint8_t* packed) {
+    // 每字节存两个符号的码长，高4位为偶数符号
+    for (int i = 0; i < HUFF_CODE_LENGTHS_SIZE; i++) {
+        packed[i] = static_cast<uint8_t>((codeLengths[2 * i] << 4) | codeLengths[2 * i + 1]);
+    }
+}
 
-    // 计算校验码
-    uint32_t calculatedCRC = std::accumulate(decompressedData.begin(), decompressedData.end(), 0xFFFFFFFF,
-        [](uint32_t currentCRC, uint8_t byte) {
-            return CRC32::update(currentCRC, byte);
-        });
-    calculatedCRC = CRC32::finalize(calculatedCRC);
+void HuffmanCompress::unpackCodeLengths(const uint8_t* packed, std::array<uint8_t, 256>& codeLengths) {
+    for (int i = 0; i < HUFF_CODE_LENGTHS_SIZE; i++) {
+        codeLengths[2 * i] = packed[i] >> 4;
+        codeLengths[2 * i + 1] = packed[i] & 0x0F;
+    }
+}
 
-    // 校验校验码
-    if (calculatedCRC != header.crc32) {
-        std::cerr << "Error: CRC32 checksum mismatch. Decompressed data may be corrupted.\n";
-        out.close();
-        in.close();
+void HuffmanCompress::setCompressionLevel(int newLevel) {
+    level = std::min(std::max(newLevel, COMPRESS_MIN_LEVEL), COMPRESS_MAX_LEVEL);
+    if (level <= 3) {
+        setBlockSize(HUFF_DEFAULT_BLOCK_SIZE / 4);
+    } else if (level <= 6) {
+        setBlockSize(HUFF_DEFAULT_BLOCK_SIZE);
+    } else {
+        setBlockSize(HUFF_DEFAULT_BLOCK_SIZE * 4);
+    }
+}
+
+void HuffmanCompress::setBlockSize(size_t size) {
+    blockSize = std::min<size_t>(std::max<size_t>(size, HUFF_MIN_BLOCK_SIZE), HUFF_MAX_BLOCK_SIZE);
+}
+
+std::array<size_t, HUFF_STREAM_COUNT> HuffmanCompress::streamCounts(size_t size) {
+    std::array<size_t, HUFF_STREAM_COUNT> counts{};
+    const size_t segment = (size + HUFF_STREAM_COUNT - 1) / HUFF_STREAM_COUNT;
+    size_t remaining = size;
+    for (int k = 0; k < HUFF_STREAM_COUNT; k++) {
+        counts[k] = k == HUFF_STREAM_COUNT - 1 ? remaining : std::min(segment, remaining);
+        remaining -= counts[k];
+    }
+    return counts;
+}
+
+HuffmanCompress::EncodedBlock HuffmanCompress::encodeBlock(const std::vector<uint8_t>& input) {
+    EncodedBlock block;
+    block.crc32 = CRC32::calculate(input);
+
+    // 统计本块词频，生成本块的码表
+    std::array<uint64_t, 256> freq = {0};
+    for (uint8_t byte : input) {
+        ++freq[byte];
+    }
+    std::array<uint8_t, 256> codeLengths = buildCodeLengths(freq);
+    std::array<std::vector<bool>, 256> codes;
+    generateCanonicalCodes(codeLengths, codes);
+
+    // 块数据 = 码长表 + 跳转表 + 编码数据
+    uint64_t totalBits = 0;
+    for (int i = 0; i < 256; i++) {
+        totalBits += freq[i] * codeLengths[i];
+    }
+
+    // 编码几乎不能减小数据（已压缩/加密的数据）时直接原样存储，解压时也不需要解码
+    const size_t prefixSize = HUFF_CODE_LENGTHS_SIZE + HUFF_JUMP_TABLE_SIZE;
+    const uint64_t encodedSize = prefixSize + (totalBits + 7) / 8;
+    if (encodedSize + input.size() / HUFF_STORE_THRESHOLD >= input.size()) {
+        block.data = input;
+        block.stored = true;
+        return block;
+    }
+    // 各位流分别按字节补齐，最多多出 HUFF_STREAM_COUNT 个字节
+    block.data.resize(static_cast<size_t>(encodedSize) + HUFF_STREAM_COUNT);
+    packCodeLengths(codeLengths, block.data.data());
+
+    HuffmanEncodeTable table;
+    table.build(codes);
+
+    // 4段分别编码为独立位流，跳转表记录前3个位流的字节数
+    const std::array<size_t, HUFF_STREAM_COUNT> counts = streamCounts(input.size());
+    uint8_t* jumpTable = block.data.data() + HUFF_CODE_LENGTHS_SIZE;
+    size_t pos = prefixSize;
+    size_t consumed = 0;
+    for (int k = 0; k < HUFF_STREAM_COUNT; k++) {
+        HuffmanBitWriter writer(block.data.data() + pos);
+        table.encode(input.data() + consumed, counts[k], writer);
+        uint32_t streamSize = static_cast<uint32_t>(writer.finish());
+        if (k < HUFF_STREAM_COUNT - 1) {
+            std::memcpy(jumpTable + 4 * k, &streamSize, sizeof(streamSize));
+        }
+        pos += streamSize;
+        consumed += counts[k];
+    }
+    block.data.resize(pos);
+    return block;
+}
+
+bool HuffmanCompress::decodeTreeBits(HNode* root, const uint8_t* data, size_t size, uint8_t* dst, size_t count) {
+    HNode* currentNode = root;
+    size_t decodedCount = 0;
+    for (size_t i = 0; i < size && decodedCount < count; i++) {
+        for (int j = 0; j < 8 && decodedCount < count; j++) {
+            currentNode = ((data[i] >> (7 - j)) & 1) ? currentNode->right : currentNode->left;
+            if (!currentNode) return false;
+            if (currentNode->isLeaf()) {
+                dst[decodedCount++] = currentNode->byte;
+                currentNode = root;
+            }
+        }
+    }
+    return decodedCount == count;
+}
+
+bool HuffmanCompress::decodeBlock(const std::vector<uint8_t>& block, const HuffBlockEntry& entry,
+                                  HuffmanDecodeMode mode, std::vector<uint8_t>& output) {
+    if (entry.flags & HUFF_BLOCK_STORED) {
+        if (block.size() != entry.originalSize) return false;
+        output = block;
+        return CRC32::calculate(output) == entry.crc32;
+    }
+
+    const size_t prefixSize = HUFF_CODE_LENGTHS_SIZE + HUFF_JUMP_TABLE_SIZE;
+    if (block.size() < prefixSize) return false;
+
+    // 读取本块码长表，生成编码
+    std::array<uint8_t, 256> codeLengths;
+    unpackCodeLengths(block.data(), codeLengths);
+    std::array<std::vector<bool>, 256> codes;
+    if (!generateCanonicalCodes(codeLengths, codes)) return false;
+
+    // 由跳转表得到各位流的位置
+    output.resize(entry.originalSize);
+    std::array<const uint8_t*, HUFF_STREAM_COUNT> streams{};
+    std::array<size_t, HUFF_STREAM_COUNT> streamSizes{};
+    std::array<uint8_t*, HUFF_STREAM_COUNT> dst{};
+    const std::array<size_t, HUFF_STREAM_COUNT> counts = streamCounts(output.size());
+    size_t remaining = block.size() - prefixSize;
+    for (int k = 0; k < HUFF_STREAM_COUNT; k++) {
+        uint32_t streamSize = static_cast<uint32_t>(remaining);
+        if (k < HUFF_STREAM_COUNT - 1) {
+            std::memcpy(&streamSize, block.data() + HUFF_CODE_LENGTHS_SIZE + 4 * k, sizeof(streamSize));
+            if (streamSize > remaining) return false;
+        }
+        streams[k] = k == 0 ? block.data() + prefixSize : streams[k - 1] + streamSizes[k - 1];
+        streamSizes[k] = streamSize;
+        dst[k] = k == 0 ? output.data() : dst[k - 1] + counts[k - 1];
+        remaining -= streamSize;
+    }
+
+    bool decoded = true;
+    if (mode == HuffmanDecodeMode::Table) {
+        HuffmanDecodeTable table;
+        if (!table.build(codes)) return false;
+        HuffmanBitReader r0(streams[0], streamSizes[0]), r1(streams[1], streamSizes[1]);
+        HuffmanBitReader r2(streams[2], streamSizes[2]), r3(streams[3], streamSizes[3]);
+        HuffmanBitReader* readers[HUFF_STREAM_COUNT] = {&r0, &r1, &r2, &r3};
+        decoded = table.decodeInterleaved(readers, dst.data(), counts.data());
+    } else {
+        // 逐位解码，各位流依次解码
+        HNode* root = buildTreeFromCodes(codes);
+        for (int k = 0; k < HUFF_STREAM_COUNT && decoded; k++) {
+            decoded = decodeTreeBits(root, streams[k], streamSizes[k], dst[k], counts[k]);
+        }
+        deleteHuffmanTree(root);
+    }
+    return decoded && CRC32::calculate(output) == entry.crc32;
+}
+
+bool HuffmanCompress::compressBlocks(std::istream& in, uint64_t originalSize, std::ostream& out) const {
+    auto fail = [](const std::string& message) {
+        std::cerr << "Error: " << message << "\n";
         return false;
+    };
+
+    uint64_t blockCount = (originalSize + blockSize - 1) / blockSize;
+    if (blockCount > UINT32_MAX) {
+        return fail("Source data is too large for the block size.");
     }
 
-    // 将解压后的数据写入目标文件
-    out.write(reinterpret_cast<const char*>(decompressedData.data()), decompressedData.size());
+    HuffBlockIndexHead indexHead;
+    indexHead.blockSize = static_cast<uint32_t>(blockSize);
+    indexHead.blockCount = static_cast<uint32_t>(blockCount);
+    std::vector<HuffBlockEntry> entries(indexHead.blockCount);
 
+    // 创建文件头信息，块索引先占位，压缩完成后回写
+    Head header{};
+    header.isCompress = 0x21;
+    header.compressType = CompressType::Huffman;
+    header.validBits = 0;
+    header.version = static_cast<uint8_t>(HuffmanFormat::Blocked);
+    header.headerSize = sizeof(Head);
+    header.freqTableSize = static_cast<uint32_t>(sizeof(HuffBlockIndexHead) +
+                                                  entries.size() * sizeof(HuffBlockEntry));
+    header.originalSize = originalSize;
+    header.crc32 = 0;
 
-    out.close();
-    in.close();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
+    out.write(reinterpret_cast<const char*>(&indexHead), sizeof(HuffBlockIndexHead));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(HuffBlockEntry));
+    uint64_t offset = sizeof(Head) + header.freqTableSize;
+
+    // 主线程顺序读取并分发，工作线程编码，按顺序写出；在途块数有上限以限制内存
+    // 单线程时直接在主线程编码，不创建线程池
+    const size_t threads = threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount;
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1) pool = std::make_unique<ThreadPool>(threads);
+    const size_t maxPending = threads * 2;
+    std::deque<std::future<EncodedBlock>> pending;
+    size_t writtenBlocks = 0;
+    // 整个文件的CRC由各块在工作线程上算出的CRC按顺序合并得到，主线程不再逐字节计算
+    uint32_t fileCRC = 0;  // 空数据的CRC32
+
+    auto writeBlock = [&](const EncodedBlock& block) {
+        HuffBlockEntry& entry = entries[writtenBlocks++];
+        entry.offset = offset;
+        entry.compressedSize = static_cast<uint32_t>(block.data.size());
+        entry.crc32 = block.crc32;
+        entry.flags = block.stored ? HUFF_BLOCK_STORED : 0;
+        fileCRC = CRC32::combine(fileCRC, block.crc32, entry.originalSize);
+        out.write(reinterpret_cast<const char*>(block.data.data()), block.data.size());
+        offset += block.data.size();
+    };
+    auto writeFront = [&]() {
+        writeBlock(pending.front().get());
+        pending.pop_front();
+    };
+
+    uint64_t remaining = originalSize;
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t size = static_cast<size_t>(std::min<uint64_t>(blockSize, remaining));
+        std::vector<uint8_t> buffer(size);
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+        if (static_cast<size_t>(in.gcount()) != size) {
+            return fail("Source data changed during compression.");
+        }
+        remaining -= size;
+        entries[i].originalSize = static_cast<uint32_t>(size);
+        entries[i].flags = 0;
+
+        if (!pool) {
+            writeBlock(encodeBlock(buffer));
+            continue;
+        }
+        pending.push_back(pool->submit([data = std::move(buffer)]() { return encodeBlock(data); }));
+        if (pending.size() >= maxPending) writeFront();
+    }
+    while (!pending.empty()) writeFront();
+
+    if (in.peek() != std::char_traits<char>::eof()) {
+        return fail("Source data changed during compression.");
+    }
+
+    // 回写文件头和块索引
+    header.crc32 = fileCRC;
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
+    out.write(reinterpret_cast<const char*>(&indexHead), sizeof(HuffBlockIndexHead));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(HuffBlockEntry));
+    if (!out) {
+        return fail("Failed to write compressed data.");
+    }
+    return true;
+}
+
+bool HuffmanCompress::decompressBlocks(std::istream& in, const Head& header, HuffmanOutputBuffer& output) const {
+    // 读取块索引
+    HuffBlockIndexHead indexHead;
+    in.read(reinterpret_cast<char*>(&indexHead), sizeof(HuffBlockIndexHead));
+    if (!in || indexHead.blockSize == 0 || indexHead.blockSize > HUFF_MAX_BLOCK_SIZE ||
+        header.freqTableSize != sizeof(HuffBlockIndexHead) +
+                                static_cast<uint64_t>(indexHead.blockCount) * sizeof(HuffBlockEntry)) {
+        return false;
+    }
+    std::vector<HuffBlockEntry> entries(indexHead.blockCount);
+    in.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(HuffBlockEntry));
+    if (!in) return false;
+
+    // 校验索引
+    uint64_t totalSize = 0;
+    for (const auto& entry : entries) {
+        if (entry.originalSize > indexHead.blockSize || (entry.flags & ~HUFF_BLOCK_STORED) != 0 ||
+            entry.compressedSize > HUFF_CODE_LENGTHS_SIZE + HUFF_JUMP_TABLE_SIZE +
+                                   static_cast<uint64_t>(indexHead.blockSize) * 2) {
+            return false;
+        }
+        totalSize += entry.originalSize;
+    }
+    if (totalSize != header.originalSize) return false;
+
+    // 主线程顺序读取各块，工作线程解码校验，按顺序写出
+    // 单线程或只有一块时直接在主线程解码，不创建线程池
+    const size_t threads = threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount;
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1 && entries.size() > 1) pool = std::make_unique<ThreadPool>(threads);
+    const size_t maxPending = threads * 2;
+    std::deque<std::future<std::pair<bool, std::vector<uint8_t>>>> pending;
+    const HuffmanDecodeMode mode = decodeMode;
+    size_t writtenBlocks = 0;
+
+    auto writeFront = [&]() {
+        std::pair<bool, std::vector<uint8_t>> decoded = pending.front().get();
+        pending.pop_front();
+        // 块CRC已在解码时校验，直接合并到文件CRC中
+        const uint32_t blockCRC = entries[writtenBlocks++].crc32;
+        return decoded.first && output.write(decoded.second.data(), decoded.second.size(), blockCRC);
+    };
+
+    for (const auto& entry : entries) {
+        std::vector<uint8_t> block(entry.compressedSize);
+        in.seekg(static_cast<std::streamoff>(entry.offset), std::ios::beg);
+        in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size()));
+        if (!in) return false;
+
+        if (!pool) {
+            std::vector<uint8_t> decoded;
+            if (!decodeBlock(block, entry, mode, decoded) ||
+                !output.write(decoded.data(), decoded.size(), entry.crc32)) {
+                return false;
+            }
+            continue;
+        }
+        pending.push_back(pool->submit([data = std::move(block), entry, mode]() {
+            std::pair<bool, std::vector<uint8_t>> result;
+            result.first = decodeBlock(data, entry, mode, result.second);
+            return result;
+        }));
+        if (pending.size() >= maxPending && !writeFront()) return false;
+    }
+    while (!pending.empty()) {
+        if (!writeFront()) return false;
+    }
     return true;
 }
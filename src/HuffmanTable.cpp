@@ -0,0 +1,61 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "HuffmanTable.h"
+
+bool HuffmanDecodeTable::build(const std::array<std::vector<bool>, 256>& codes) {
+    // 先把所有编码插入编码树，根节点下标为0
+    nodes.assign(1, Node{{kNoChild, kNoChild}});
+    for (int sym = 0; sym < 256; ++sym) {
+        const std::vector<bool>& code = codes[sym];
+        if (code.empty()) continue;
+        int32_t cur = 0;
+        for (size_t i = 0; i < code.size(); ++i) {
+            int32_t& child = nodes[cur].child[code[i] ? 1 : 0];
+            if (i + 1 == code.size()) {
+                // 最后一位挂叶子，分支已被占用说明不是前缀码
+                if (child != kNoChild) return false;
+                child = -(sym + 1);
+                break;
+            }
+            if (child < 0) return false;  // 经过了别的符号的叶子
+            if (child == kNoChild) {
+                child = static_cast<int32_t>(nodes.size());
+                nodes.push_back(Node{{kNoChild, kNoChild}});  // push_back后child引用失效，不能再使用
+            }
+            cur = nodes[cur].child[code[i] ? 1 : 0];
+        }
+    }
+
+    // 枚举所有 HUFF_TABLE_BITS 位的前缀，在编码树上走一遍填表
+    for (uint32_t index = 0; index < table.size(); ++index) {
+        Entry entry{0, 0, EntryKind::Invalid};
+        int32_t cur = 0;
+        for (int depth = 1; depth <= HUFF_TABLE_BITS; ++depth) {
+            bool bit = (index >> (HUFF_TABLE_BITS - depth)) & 1;
+            int32_t next = nodes[cur].child[bit ? 1 : 0];
+            if (next == kNoChild) break;
+            if (next < 0) {
+                entry = Entry{static_cast<uint16_t>(-next - 1), static_cast<uint8_t>(depth), EntryKind::Symbol};
+                break;
+            }
+            cur = next;
+            if (depth == HUFF_TABLE_BITS) {
+                entry = Entry{static_cast<uint16_t>(cur), HUFF_TABLE_BITS, EntryKind::Long};
+            }
+        }
+        table[index] = entry;
+    }
+    return true;
+}
+
+bool HuffmanEncodeTable::build(const std::array<std::vector<bool>, 256>& codes) {
+    for (int sym = 0; sym < 256; ++sym) {
+        const std::vector<bool>& code = codes[sym];
+        if (code.size() > 32) return false;
+        uint32_t value = 0;
+        for (bool bit : code) {
+            value = (value << 1) | (bit ? 1u : 0u);
+        }
+        table[sym] = Code{value, static_cast<uint8_t>(code.size())};
+    }
+    return true;
+}
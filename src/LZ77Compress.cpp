@@ -0,0 +1,444 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "LZ77Compress.h"
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+// 读取4字节（用于匹配比较和哈希）
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t v) {
+    return (v * 2654435761u) >> (32 - LZ_HASH_LOG);
+}
+
+// 写入扩展长度：每字节最多255，最后一字节小于255
+static inline void writeLength(std::vector<uint8_t>& dst, size_t len) {
+    while (len >= 255) {
+        dst.push_back(255);
+        len -= 255;
+    }
+    dst.push_back(static_cast<uint8_t>(len));
+}
+
+// 写出一个序列：字面量 [literal, literal + literalLen)，随后是匹配（matchLen为0时表示最后一个序列）
+static void writeSequence(std::vector<uint8_t>& dst, const uint8_t* literal, size_t literalLen,
+                          size_t offset, size_t matchLen) {
+    size_t tokenPos = dst.size();
+    dst.push_back(0);
+    uint8_t token = static_cast<uint8_t>(std::min<size_t>(literalLen, 15) << 4);
+    if (literalLen >= 15) writeLength(dst, literalLen - 15);
+    dst.insert(dst.end(), literal, literal + literalLen);
+
+    if (matchLen > 0) {
+        dst.push_back(static_cast<uint8_t>(offset & 0xFF));
+        dst.push_back(static_cast<uint8_t>(offset >> 8));
+        size_t len = matchLen - LZ_MIN_MATCH;
+        token |= static_cast<uint8_t>(std::min<size_t>(len, 15));
+        if (len >= 15) writeLength(dst, len - 15);
+    }
+    dst[tokenPos] = token;
+}
+
+void LZ77Compress::setCompressionLevel(int newLevel) {
+    level = std::min(std::max(newLevel, COMPRESS_MIN_LEVEL), COMPRESS_MAX_LEVEL);
+}
+
+static_assert(LZ_DEFAULT_BLOCK_SIZE * 4 <= COMPRESS_MAX_BLOCK_SIZE, "LZ77 block size exceeds COMPRESS_MAX_BLOCK_SIZE");
+
+LZLevelParams LZ77Compress::getLevelParams(int level) {
+    static const LZLevelParams params[] = {
+        // 深度, 加速, 惰性, 块大小, 熵编码
+        {1, 6, false, LZ_DEFAULT_BLOCK_SIZE, false},  // 1
+        {2, 6, false, LZ_DEFAULT_BLOCK_SIZE, false},  // 2
+        {4, 7, false, LZ_DEFAULT_BLOCK_SIZE, false},  // 3
+        {8, 0, false, LZ_DEFAULT_BLOCK_SIZE, false},  // 4
+        {16, 0, true, LZ_DEFAULT_BLOCK_SIZE, false},  // 5
+        {32, 0, true, LZ_DEFAULT_BLOCK_SIZE, true},  // 6
+        {64, 0, true, LZ_DEFAULT_BLOCK_SIZE * 4, true},  // 7
+        {128, 0, true, LZ_DEFAULT_BLOCK_SIZE * 4, true},  // 8
+        {256, 0, true, LZ_DEFAULT_BLOCK_SIZE * 4, true},  // 9
+    };
+    level = std::min(std::max(level, COMPRESS_MIN_LEVEL), COMPRESS_MAX_LEVEL);
+    return params[level - COMPRESS_MIN_LEVEL];
+}
+
+size_t LZ77Compress::compressBlock(const uint8_t* src, size_t size, std::vector<uint8_t>& dst,
+                                   const LZLevelParams& params) {
+    const size_t start = dst.size();
+    size_t anchor = 0;  // 尚未输出的字面量起点
+
+    if (size > LZ_MATCH_LIMIT) {
+        // 哈希表记录每个4字节序列最近一次出现的位置，哈希链记录同一哈希值的上一个位置
+        std::vector<uint32_t> hashTable(1u << LZ_HASH_LOG, 0);
+        std::vector<uint32_t> chain(params.searchDepth > 1 ? LZ_CHAIN_SIZE : 0, 0);
+        const size_t matchLimit = size - LZ_MATCH_LIMIT;
+
+        auto insert = [&](size_t pos) {
+            uint32_t& head = hashTable[hash32(read32(src + pos))];
+            if (!chain.empty()) chain[pos & (LZ_CHAIN_SIZE - 1)] = head;
+            head = static_cast<uint32_t>(pos);
+        };
+
+        // 在窗口内查找 pos 处的最长匹配，返回匹配长度（0 表示没有）
+        auto findMatch = [&](size_t pos, size_t& matchPos) {
+            const uint32_t sequence = read32(src + pos);
+            size_t candidate = hashTable[hash32(sequence)];
+            size_t best = 0;
+            for (int depth = 0; depth < params.searchDepth; ++depth) {
+                if (candidate >= pos || pos - candidate > LZ_MAX_OFFSET) break;
+                if (read32(src + candidate) == sequence) {
+                    size_t len = LZ_MIN_MATCH;
+                    while (pos + len < size && src[candidate + len] == src[pos + len]) len++;
+                    if (len > best) {
+                        best = len;
+                        matchPos = candidate;
+                        if (pos + len == size) break;
+                    }
+                }
+                if (chain.empty()) break;
+                size_t next = chain[candidate & (LZ_CHAIN_SIZE - 1)];
+                if (next >= candidate) break;  // 链上的旧位置已被覆盖
+                candidate = next;
+            }
+            return best;
+        };
+
+        size_t ip = 0;
+        while (ip < matchLimit) {
+            size_t candidate = 0;
+            size_t matchLen = findMatch(ip, candidate);
+            insert(ip);
+            if (matchLen == 0) {
+                // 未命中：离上次匹配越远步长越大，快速跳过不可压缩的数据
+                ip += 1 + (params.skipShift > 0 ? (ip - anchor) >> params.skipShift : 0);
+                continue;
+            }
+
+            // 惰性匹配：下一个位置的匹配更长就放弃当前匹配
+            while (params.lazy && ip + 1 < matchLimit) {
+                size_t nextCandidate = 0;
+                size_t nextLen = findMatch(ip + 1, nextCandidate);
+                if (nextLen <= matchLen) break;
+                insert(++ip);
+                matchLen = nextLen;
+                candidate = nextCandidate;
+            }
+
+            // 向前扩展匹配
+            while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1]) {
+                ip--;
+                candidate--;
+                matchLen++;
+            }
+
+            writeSequence(dst, src + anchor, ip - anchor, ip - candidate, matchLen);
+            const size_t matchEnd = ip + matchLen;
+
+            if (!chain.empty()) {
+                // 搜索较深时把匹配覆盖的位置都加入哈希链
+                for (size_t pos = ip + 1; pos < matchEnd && pos < matchLimit; ++pos) insert(pos);
+            } else if (matchEnd < matchLimit) {
+                // 把匹配末尾附近的位置也加入哈希表，提高后续命中率
+                insert(matchEnd - 2);
+            }
+            ip = matchEnd;
+            anchor = ip;
+        }
+    }
+
+    // 剩余部分作为最后一个序列的字面量
+    writeSequence(dst, src + anchor, size - anchor, 0, 0);
+    return dst.size() - start;
+}
+
+bool LZ77Compress::decompressBlock(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + size;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dstSize;
+
+    // 读取扩展长度
+    auto readLength = [&](size_t& len) {
+        uint8_t b;
+        do {
+            if (ip >= iend) return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+
+        // 字面量
+        size_t literalLen = token >> 4;
+        if (literalLen == 15 && !readLength(literalLen)) return false;
+        if (literalLen > static_cast<size_t>(iend - ip) || literalLen > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+        if (op == oend) return ip == iend;  // 最后一个序列只有字面量，之后不应再有数据
+
+        // 匹配
+        if (iend - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLen = token & 0x0F;
+        if (matchLen == 15 && !readLength(matchLen)) return false;
+        matchLen += LZ_MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) || matchLen > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        const uint8_t* match = op - offset;
+        if (offset >= matchLen) {
+            std::memcpy(op, match, matchLen);
+            op += matchLen;
+        } else {
+            // 重叠复制（如连续重复的字节），只能逐字节进行
+            for (size_t i = 0; i < matchLen; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+    return false;  // 缺少最后一个序列
+}
+
+std::string LZ77Compress::compressFile(const std::string& sourcePath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in || !in.is_open()) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        return "";
+    }
+
+    // 在原先文件基础上增加后缀即可
+    std::string destPath = sourcePath + ".lz";
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out || !out.is_open()) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        return "";
+    }
+
+    if (!compressStream(in, out)) {
+        std::cerr << "Error: Failed to write file " << destPath << ".\n";
+        out.close();
+        std::error_code ec;
+        fs::remove(destPath, ec);
+        return "";
+    }
+    out.close();
+    in.close();
+    return destPath;
+}
+
+bool LZ77Compress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    destData.clear();
+    MemoryInputStream in(sourceData.data(), sourceData.size());
+    VectorOutputStream out(destData);
+    if (!compressStream(in, out)) {
+        destData.clear();
+        return false;
+    }
+    return true;
+}
+
+bool LZ77Compress::compressStream(std::istream& in, std::ostream& out) const {
+    // 创建文件头信息，原始大小和CRC在压缩完成后回写
+    const LZLevelParams params = getLevelParams(level);
+    LZHead header{};
+    header.isCompress = 0x21;
+    header.compressType = CompressType::LZ77;
+    header.version = LZ_FORMAT_VERSION;
+    header.level = static_cast<uint8_t>(level);
+    header.headerSize = sizeof(LZHead);
+    header.blockSize = params.blockSize;
+    header.originalSize = 0;
+    header.crc32 = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(LZHead));
+
+    std::vector<uint8_t> readBuffer(header.blockSize);
+    std::vector<uint8_t> compressed;
+    compressed.reserve(header.blockSize + header.blockSize / 255 + 16);
+    uint32_t crcValue = CRC32::getInitialValue();
+
+    while (in) {
+        in.read(reinterpret_cast<char*>(readBuffer.data()), static_cast<std::streamsize>(readBuffer.size()));
+        std::streamsize n = in.gcount();
+        if (n <= 0) break;
+        crcValue = CRC32::update(crcValue, readBuffer.data(), static_cast<size_t>(n));
+        header.originalSize += static_cast<uint64_t>(n);
+
+        compressed.clear();
+        size_t compressedSize = compressBlock(readBuffer.data(), static_cast<size_t>(n), compressed, params);
+        LZBlockHead blockHead;
+        blockHead.originalSize = static_cast<uint32_t>(n);
+
+        // 熵编码阶段：只有比LZ输出更小时才使用
+        HuffmanCompress::EncodedBlock entropyBlock;
+        size_t entropySize = 0;
+        if (params.entropy) {
+            entropyBlock = HuffmanCompress::encodeBlock(compressed);
+            entropySize = sizeof(LZEntropyHead) + entropyBlock.data.size();
+        }
+
+        if (params.entropy && !entropyBlock.stored && entropySize < compressedSize && entropySize < static_cast<size_t>(n)) {
+            LZEntropyHead entropyHead;
+            entropyHead.lzSize = static_cast<uint32_t>(compressedSize);
+            entropyHead.crc32 = entropyBlock.crc32;
+            blockHead.compressedSize = static_cast<uint32_t>(entropySize) | LZ_ENTROPY_BLOCK_FLAG;
+            out.write(reinterpret_cast<const char*>(&blockHead), sizeof(LZBlockHead));
+            out.write(reinterpret_cast<const char*>(&entropyHead), sizeof(LZEntropyHead));
+            out.write(reinterpret_cast<const char*>(entropyBlock.data.data()), entropyBlock.data.size());
+        } else if (compressedSize < static_cast<size_t>(n)) {
+            blockHead.compressedSize = static_cast<uint32_t>(compressedSize);
+            out.write(reinterpret_cast<const char*>(&blockHead), sizeof(LZBlockHead));
+            out.write(reinterpret_cast<const char*>(compressed.data()), compressedSize);
+        } else {
+            // 压缩后没有变小的块原样存储
+            blockHead.compressedSize = static_cast<uint32_t>(n) | LZ_RAW_BLOCK_FLAG;
+            out.write(reinterpret_cast<const char*>(&blockHead), sizeof(LZBlockHead));
+            out.write(reinterpret_cast<const char*>(readBuffer.data()), n);
+        }
+    }
+
+    // 回写文件头
+    header.crc32 = CRC32::finalize(crcValue);
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(LZHead));
+    return static_cast<bool>(out);
+}
+
+bool LZ77Compress::decompressFile(const std::string& sourcePath, const std::string& destPath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in || !in.is_open()) {
+        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        return false;
+    }
+
+    // 读取并校验头信息
+    LZHead header;
+    if (!readHeader(in, sourcePath, header)) return false;
+
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out || !out.is_open()) {
+        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        return false;
+    }
+
+    // 出错时删除不完整的输出文件
+    if (!decodeStream(in, sourcePath, header, out)) {
+        out.close();
+        std::error_code ec;
+        fs::remove(destPath, ec);
+        return false;
+    }
+    out.close();
+    return true;
+}
+
+bool LZ77Compress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    destData.clear();
+    MemoryInputStream in(sourceData.data(), sourceData.size());
+    LZHead header;
+    if (!readHeader(in, "memory buffer", header)) return false;
+
+    reserveDecompressOutput(destData, header.originalSize, sourceData.size());
+    VectorOutputStream out(destData);
+    if (!decodeStream(in, "memory buffer", header, out)) {
+        destData.clear();
+        return false;
+    }
+    return true;
+}
+
+bool LZ77Compress::readHeader(std::istream& in, const std::string& sourceName, LZHead& header) {
+    in.read(reinterpret_cast<char*>(&header), sizeof(LZHead));
+    if (!in || header.isCompress != 0x21 || header.compressType != CompressType::LZ77 ||
+        header.blockSize == 0 || header.blockSize > COMPRESS_MAX_BLOCK_SIZE) {
+        std::cerr << "Error: File " << sourceName << " is not a LZ77 compressed file.\n";
+        return false;
+    }
+    if (header.version > LZ_FORMAT_VERSION) {
+        std::cerr << "Error: Unsupported LZ77 format version " << static_cast<int>(header.version)
+                  << " in " << sourceName << ".\n";
+        return false;
+    }
+    return true;
+}
+
+bool LZ77Compress::decodeStream(std::istream& in, const std::string& sourceName, const LZHead& header,
+                                std::ostream& out) {
+    auto fail = [](const std::string& message) {
+        std::cerr << "Error: " << message << "\n";
+        return false;
+    };
+
+    std::vector<uint8_t> blockData;
+    std::vector<uint8_t> entropyData;
+    std::vector<uint8_t> decompressed(header.blockSize);
+    uint32_t crcValue = CRC32::getInitialValue();
+    uint64_t totalSize = 0;
+
+    // 逐块解压，内存占用只与块大小有关
+    while (totalSize < header.originalSize) {
+        LZBlockHead blockHead;
+        in.read(reinterpret_cast<char*>(&blockHead), sizeof(LZBlockHead));
+        const bool raw = (blockHead.compressedSize & LZ_RAW_BLOCK_FLAG) != 0;
+        const bool entropy = (blockHead.compressedSize & LZ_ENTROPY_BLOCK_FLAG) != 0;
+        const uint32_t dataSize = blockHead.compressedSize & LZ_BLOCK_SIZE_MASK;
+        if (!in || blockHead.originalSize == 0 || blockHead.originalSize > header.blockSize ||
+            blockHead.originalSize > header.originalSize - totalSize || (raw && entropy) ||
+            (raw ? dataSize != blockHead.originalSize : dataSize >= blockHead.originalSize)) {
+            return fail("Invalid block header in " + sourceName + ".");
+        }
+
+        blockData.resize(dataSize);
+        in.read(reinterpret_cast<char*>(blockData.data()), dataSize);
+        if (!in) {
+            return fail("Unexpected end of compressed data in " + sourceName + ".");
+        }
+
+        // 先还原熵编码，得到LZ输出
+        if (entropy) {
+            LZEntropyHead entropyHead;
+            if (dataSize < sizeof(LZEntropyHead)) {
+                return fail("Invalid block header in " + sourceName + ".");
+            }
+            std::memcpy(&entropyHead, blockData.data(), sizeof(LZEntropyHead));
+            blockData.erase(blockData.begin(), blockData.begin() + sizeof(LZEntropyHead));
+            HuffBlockEntry entry{0, entropyHead.lzSize, 0, entropyHead.crc32, 0};
+            if (entropyHead.lzSize > blockHead.originalSize + blockHead.originalSize / 255 + 16 ||
+                !HuffmanCompress::decodeBlock(blockData, entry, HuffmanDecodeMode::Table, entropyData)) {
+                return fail("Corrupted block in " + sourceName + ".");
+            }
+            blockData.swap(entropyData);
+        }
+
+        const uint8_t* output = blockData.data();
+        if (!raw) {
+            if (!decompressBlock(blockData.data(), blockData.size(), decompressed.data(), blockHead.originalSize)) {
+                return fail("Corrupted block in " + sourceName + ".");
+            }
+            output = decompressed.data();
+        }
+
+        crcValue = CRC32::update(crcValue, output, blockHead.originalSize);
+        out.write(reinterpret_cast<const char*>(output), blockHead.originalSize);
+        totalSize += blockHead.originalSize;
+    }
+
+    if (CRC32::finalize(crcValue) != header.crc32) {
+        return fail("CRC32 checksum mismatch. Decompressed data may be corrupted.");
+    }
+    if (!out) {
+        return fail("Failed to write decompressed data of " + sourceName + ".");
+    }
+    return true;
+}
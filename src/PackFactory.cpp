@@ -55,5 +55,7 @@ bool PackFactory::isPackedFile(const std::string& filePath) {
     }
     uint8_t firstByte;
     in.read(reinterpret_cast<char*>(&firstByte), sizeof(firstByte));
-    return firstByte == 0x01 && getPackType(filePath) != "";
+    // 第一个字节为包格式（PackFormat::Inline / PackFormat::Indexed）
+    return (firstByte == static_cast<uint8_t>(PackFormat::Inline) ||
+            firstByte == static_cast<uint8_t>(PackFormat::Indexed)) && getPackType(filePath) != "";
 }
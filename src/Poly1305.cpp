@@ -0,0 +1,181 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "Poly1305.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kMask26 = 0x3ffffff;
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void storeLE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+}  // namespace
+
+Poly1305::Poly1305(const uint8_t* key) {
+    // r 按 RFC 要求清除部分位（clamp），拆成5个26位分量
+    r[0] = loadLE32(key) & 0x3ffffff;
+    r[1] = (loadLE32(key + 3) >> 2) & 0x3ffff03;
+    r[2] = (loadLE32(key + 6) >> 4) & 0x3ffc0ff;
+    r[3] = (loadLE32(key + 9) >> 6) & 0x3f03fff;
+    r[4] = (loadLE32(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 4; ++i) {
+        pad[i] = loadLE32(key + 16 + i * 4);
+    }
+}
+
+void Poly1305::blocks(const uint8_t* data, size_t size, bool final) {
+    const uint32_t hibit = final ? 0 : (1u << 24);  // 完整分组在第128位补1
+    const uint64_t r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+    // 2^130 ≡ 5 (mod 2^130 - 5)，高位乘积折回低位时乘以5
+    const uint64_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+
+    for (; size >= 16; data += 16, size -= 16) {
+        // h += m
+        h0 += loadLE32(data) & kMask26;
+        h1 += (loadLE32(data + 3) >> 2) & kMask26;
+        h2 += (loadLE32(data + 6) >> 4) & kMask26;
+        h3 += (loadLE32(data + 9) >> 6) & kMask26;
+        h4 += (loadLE32(data + 12) >> 8) | hibit;
+
+        // h *= r (mod 2^130 - 5)
+        uint64_t d0 = h0 * r0 + h1 * s4 + h2 * s3 + h3 * s2 + h4 * s1;
+        uint64_t d1 = h0 * r1 + h1 * r0 + h2 * s4 + h3 * s3 + h4 * s2;
+        uint64_t d2 = h0 * r2 + h1 * r1 + h2 * r0 + h3 * s4 + h4 * s3;
+        uint64_t d3 = h0 * r3 + h1 * r2 + h2 * r1 + h3 * r0 + h4 * s4;
+        uint64_t d4 = h0 * r4 + h1 * r3 + h2 * r2 + h3 * r1 + h4 * r0;
+
+        // 部分进位，各分量回到约26位
+        uint32_t c = static_cast<uint32_t>(d0 >> 26);
+        h0 = static_cast<uint32_t>(d0) & kMask26;
+        d1 += c;
+        c = static_cast<uint32_t>(d1 >> 26);
+        h1 = static_cast<uint32_t>(d1) & kMask26;
+        d2 += c;
+        c = static_cast<uint32_t>(d2 >> 26);
+        h2 = static_cast<uint32_t>(d2) & kMask26;
+        d3 += c;
+        c = static_cast<uint32_t>(d3 >> 26);
+        h3 = static_cast<uint32_t>(d3) & kMask26;
+        d4 += c;
+        c = static_cast<uint32_t>(d4 >> 26);
+        h4 = static_cast<uint32_t>(d4) & kMask26;
+        h0 += c * 5;
+        c = h0 >> 26;
+        h0 &= kMask26;
+        h1 += c;
+    }
+
+    h[0] = h0;
+    h[1] = h1;
+    h[2] = h2;
+    h[3] = h3;
+    h[4] = h4;
+}
+
+void Poly1305::update(const uint8_t* data, size_t size) {
+    // 先补满上次剩余的不完整分组
+    if (bufferSize > 0) {
+        size_t n = std::min(size, sizeof(buffer) - bufferSize);
+        std::memcpy(buffer + bufferSize, data, n);
+        bufferSize += n;
+        data += n;
+        size -= n;
+        if (bufferSize < sizeof(buffer)) return;
+        blocks(buffer, sizeof(buffer), false);
+        bufferSize = 0;
+    }
+    size_t full = size & ~static_cast<size_t>(15);
+    if (full > 0) {
+        blocks(data, full, false);
+        data += full;
+        size -= full;
+    }
+    std::memcpy(buffer, data, size);
+    bufferSize = size;
+}
+
+Poly1305::Tag Poly1305::finish() {
+    // 最后一个不完整分组：数据后补1，其余补0
+    if (bufferSize > 0) {
+        buffer[bufferSize] = 1;
+        std::fill(buffer + bufferSize + 1, buffer + sizeof(buffer), 0);
+        blocks(buffer, sizeof(buffer), true);
+    }
+
+    // 完全进位
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+    uint32_t c = h1 >> 26;
+    h1 &= kMask26;
+    h2 += c;
+    c = h2 >> 26;
+    h2 &= kMask26;
+    h3 += c;
+    c = h3 >> 26;
+    h3 &= kMask26;
+    h4 += c;
+    c = h4 >> 26;
+    h4 &= kMask26;
+    h0 += c * 5;
+    c = h0 >> 26;
+    h0 &= kMask26;
+    h1 += c;
+
+    // g = h + 5 - 2^130，g 不为负时 h >= 2^130 - 5，取 g（无分支选择）
+    uint32_t g0 = h0 + 5;
+    c = g0 >> 26;
+    g0 &= kMask26;
+    uint32_t g1 = h1 + c;
+    c = g1 >> 26;
+    g1 &= kMask26;
+    uint32_t g2 = h2 + c;
+    c = g2 >> 26;
+    g2 &= kMask26;
+    uint32_t g3 = h3 + c;
+    c = g3 >> 26;
+    g3 &= kMask26;
+    uint32_t g4 = h4 + c - (1u << 26);
+    uint32_t mask = (g4 >> 31) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+
+    // 转为4个32位字（mod 2^128），再加上 pad
+    uint32_t w0 = h0 | (h1 << 26);
+    uint32_t w1 = (h1 >> 6) | (h2 << 20);
+    uint32_t w2 = (h2 >> 12) | (h3 << 14);
+    uint32_t w3 = (h3 >> 18) | (h4 << 8);
+    uint64_t f = static_cast<uint64_t>(w0) + pad[0];
+    w0 = static_cast<uint32_t>(f);
+    f = static_cast<uint64_t>(w1) + pad[1] + (f >> 32);
+    w1 = static_cast<uint32_t>(f);
+    f = static_cast<uint64_t>(w2) + pad[2] + (f >> 32);
+    w2 = static_cast<uint32_t>(f);
+    f = static_cast<uint64_t>(w3) + pad[3] + (f >> 32);
+    w3 = static_cast<uint32_t>(f);
+
+    Tag tag;
+    storeLE32(tag.data(), w0);
+    storeLE32(tag.data() + 4, w1);
+    storeLE32(tag.data() + 8, w2);
+    storeLE32(tag.data() + 12, w3);
+    return tag;
+}
+
+Poly1305::Tag Poly1305::mac(const uint8_t* key, const uint8_t* data, size_t size) {
+    Poly1305 poly(key);
+    poly.update(data, size);
+    return poly.finish();
+}
@@ -0,0 +1,179 @@
+// Copyright [2025] <JiJun Lu, Linru Zhou>
+#include "SHA256.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline void storeBE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+}  // namespace
+
+SHA256::SHA256()
+    : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {}
+
+void SHA256::compress(const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = loadBE32(block + i * 4);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + kRoundConstants[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void SHA256::update(const uint8_t* data, size_t size) {
+    totalSize += size;
+    // 先补满上次剩余的不完整分组
+    if (bufferSize > 0) {
+        size_t n = std::min(size, BLOCK_SIZE - bufferSize);
+        std::memcpy(buffer.data() + bufferSize, data, n);
+        bufferSize += n;
+        data += n;
+        size -= n;
+        if (bufferSize < BLOCK_SIZE) return;
+        compress(buffer.data());
+        bufferSize = 0;
+    }
+    for (; size >= BLOCK_SIZE; data += BLOCK_SIZE, size -= BLOCK_SIZE) {
+        compress(data);
+    }
+    std::memcpy(buffer.data(), data, size);
+    bufferSize = size;
+}
+
+SHA256::Digest SHA256::finish() {
+    // 填充：0x80，若干0，最后8字节为按位计的消息长度（大端）
+    const uint64_t bitLength = totalSize * 8;
+    buffer[bufferSize++] = 0x80;
+    if (bufferSize > BLOCK_SIZE - 8) {
+        std::fill(buffer.begin() + bufferSize, buffer.end(), 0);
+        compress(buffer.data());
+        bufferSize = 0;
+    }
+    std::fill(buffer.begin() + bufferSize, buffer.end() - 8, 0);
+    storeBE32(buffer.data() + BLOCK_SIZE - 8, static_cast<uint32_t>(bitLength >> 32));
+    storeBE32(buffer.data() + BLOCK_SIZE - 4, static_cast<uint32_t>(bitLength));
+    compress(buffer.data());
+
+    Digest digest;
+    for (int i = 0; i < 8; ++i) {
+        storeBE32(digest.data() + i * 4, state[i]);
+    }
+    return digest;
+}
+
+SHA256::Digest SHA256::hash(const uint8_t* data, size_t size) {
+    SHA256 sha;
+    sha.update(data, size);
+    return sha.finish();
+}
+
+namespace {
+
+// 吸收了 HMAC 内层（key ^ ipad）与外层（key ^ opad）填充块后的两个摘要状态，
+// PBKDF2 每轮迭代复制这两个状态即可，不必重复处理密钥
+struct HmacContext {
+    SHA256 inner;
+    SHA256 outer;
+
+    HmacContext(const uint8_t* key, size_t keySize) {
+        std::array<uint8_t, SHA256::BLOCK_SIZE> block{};
+        if (keySize > SHA256::BLOCK_SIZE) {
+            SHA256::Digest digest = SHA256::hash(key, keySize);
+            std::copy(digest.begin(), digest.end(), block.begin());
+        } else {
+            std::copy(key, key + keySize, block.begin());
+        }
+        std::array<uint8_t, SHA256::BLOCK_SIZE> pad;
+        for (size_t i = 0; i < pad.size(); ++i) pad[i] = block[i] ^ 0x36;
+        inner.update(pad.data(), pad.size());
+        for (size_t i = 0; i < pad.size(); ++i) pad[i] = block[i] ^ 0x5c;
+        outer.update(pad.data(), pad.size());
+    }
+
+    SHA256::Digest compute(const uint8_t* data, size_t size) const {
+        SHA256 in = inner;
+        in.update(data, size);
+        SHA256::Digest innerDigest = in.finish();
+        SHA256 out = outer;
+        out.update(innerDigest.data(), innerDigest.size());
+        return out.finish();
+    }
+};
+
+}  // namespace
+
+SHA256::Digest SHA256::hmac(const uint8_t* key, size_t keySize, const uint8_t* data, size_t size) {
+    return HmacContext(key, keySize).compute(data, size);
+}
+
+void SHA256::pbkdf2(const std::string& password, const uint8_t* salt, size_t saltSize,
+                    uint32_t iterations, uint8_t* out, size_t outSize) {
+    const HmacContext context(reinterpret_cast<const uint8_t*>(password.data()), password.size());
+    std::string first(reinterpret_cast<const char*>(salt), saltSize);
+    first.append(4, '\0');
+
+    // 第 blockIndex 个输出块 T = U1 ^ U2 ^ ... ^ Uc，U1 = HMAC(P, S || INT(blockIndex))，Uk = HMAC(P, Uk-1)
+    for (uint32_t blockIndex = 1; outSize > 0; ++blockIndex) {
+        storeBE32(reinterpret_cast<uint8_t*>(&first[saltSize]), blockIndex);
+        Digest u = context.compute(reinterpret_cast<const uint8_t*>(first.data()), first.size());
+        Digest t = u;
+        for (uint32_t i = 1; i < iterations; ++i) {
+            u = context.compute(u.data(), u.size());
+            for (size_t j = 0; j < DIGEST_SIZE; ++j) t[j] ^= u[j];
+        }
+        size_t n = std::min(outSize, DIGEST_SIZE);
+        std::copy(t.begin(), t.begin() + n, out);
+        out += n;
+        outSize -= n;
+    }
+}
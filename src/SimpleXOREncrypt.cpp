@@ -1,5 +1,104 @@
 // Copyright [2025] <JiJun Lu, Linru Zhou>
 #include "SimpleXOREncrypt.h"
+#include "CpuFeatures.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define XOR_HAS_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define XOR_TARGET_AVX2
+#define XOR_TARGET_AVX512
+#else
+#define XOR_TARGET_AVX2 __attribute__((target("avx2")))
+#define XOR_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+namespace {
+
+using XorFunction = void (*)(uint8_t*, const uint8_t*, size_t);
+
+void xorScalar(uint8_t* data, const uint8_t* keystream, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        data[i] ^= keystream[i];
+    }
+}
+
+#if defined(XOR_HAS_X86_SIMD)
+// SSE2 是 x86-64 的基础指令集，不需要检测
+void xorSse2(uint8_t* data, const uint8_t* keystream, size_t size) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        for (size_t j = i; j < i + 64; j += 16) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + j));
+            __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keystream + j));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + j), _mm_xor_si128(d, k));
+        }
+    }
+    xorScalar(data + i, keystream + i, size - i);
+}
+
+XOR_TARGET_AVX2 void xorAvx2(uint8_t* data, const uint8_t* keystream, size_t size) {
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        for (size_t j = i; j < i + 128; j += 32) {
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + j));
+            __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keystream + j));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + j), _mm256_xor_si256(d, k));
+        }
+    }
+    xorSse2(data + i, keystream + i, size - i);
+}
+
+XOR_TARGET_AVX512 void xorAvx512(uint8_t* data, const uint8_t* keystream, size_t size) {
+    size_t i = 0;
+    for (; i + 256 <= size; i += 256) {
+        for (size_t j = i; j < i + 256; j += 64) {
+            __m512i d = _mm512_loadu_si512(data + j);
+            __m512i k = _mm512_loadu_si512(keystream + j);
+            _mm512_storeu_si512(data + j, _mm512_xor_si512(d, k));
+        }
+    }
+    xorSse2(data + i, keystream + i, size - i);
+}
+#endif  // XOR_HAS_X86_SIMD
+
+struct XorKernel {
+    XorFunction function;
+    const char* name;
+};
+
+// 首次使用时按CPU特性选择一次
+const XorKernel& selectKernel() {
+    static const XorKernel kernel = []() -> XorKernel {
+#if defined(XOR_HAS_X86_SIMD)
+        if (CpuFeatures::get().avx512) return {xorAvx512, "avx512"};
+        if (CpuFeatures::get().avx2) return {xorAvx2, "avx2"};
+        return {xorSse2, "sse2"};
+#else
+        return {xorScalar, "scalar"};
+#endif
+    }();
+    return kernel;
+}
+
+}  // namespace
+
+void SimpleXOREncrypt::xorKeystream(uint8_t* data, const uint8_t* keystream, size_t size) {
+    selectKernel().function(data, keystream, size);
+}
+
+const char* SimpleXOREncrypt::getKernelName() {
+    return selectKernel().name;
+}
+
+std::vector<uint8_t> SimpleXOREncrypt::expandKey(const std::string& password) {
+    std::vector<uint8_t> keystream(BUFFER_SIZE + password.size());
+    for (size_t i = 0; i < keystream.size(); ++i) {
+        keystream[i] = static_cast<uint8_t>(password[i % password.size()]);
+    }
+    return keystream;
+}
 
 std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const std::string& key) {
     // 首先检查文件是否存在
@@ -48,16 +147,14 @@ std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const s
     }
 
     uint32_t crc32 = CRC32::getInitialValue();
+    const std::vector<uint8_t> keystream = expandKey(password);
 
     while ((bytesRead = inFile.read(buffer.data(), BUFFER_SIZE).gcount())) {
-        for (size_t i = 0; i < bytesRead; ++i) {
-            // 计算crc
-            crc32 = CRC32::update(crc32, static_cast<uint8_t>(buffer[i]));
-
-            // 加密内容
-            buffer[i] ^= password[keyIndex];
-            keyIndex = (keyIndex + 1) % keySize;
-        }
+        // 先对整块明文计算crc
+        crc32 = CRC32::update(crc32, reinterpret_cast<const uint8_t*>(buffer.data()), bytesRead);
+        // 加密内容：整块与从当前密钥位置开始的密钥流异或
+        xorKeystream(reinterpret_cast<uint8_t*>(buffer.data()), keystream.data() + keyIndex, bytesRead);
+        keyIndex = (keyIndex + bytesRead) % keySize;
         outFile.write(buffer.data(), bytesRead);
     }
 
@@ -128,16 +225,13 @@ bool SimpleXOREncrypt::decryptFile(const std::string& sourcePath,
         keySize = password.size();
     }
 
+    const std::vector<uint8_t> keystream = expandKey(password);
+
     while ((bytesRead = inFile.read(buffer.data(), BUFFER_SIZE).gcount()) > 0) {
-        // 对数据进行CRC计算
-        for (size_t i = 0; i < bytesRead; ++i) {
-            // 先解密，再计算crc32
-            // 解密数据
-            buffer[i] ^= password[keyIndex];
-            keyIndex = (keyIndex + 1) % keySize;
-            // 计算crc
-            crc32 = CRC32::update(crc32, static_cast<uint8_t>(buffer[i]));
-        }
+        // 先解密，再对整块明文计算crc32
+        xorKeystream(reinterpret_cast<uint8_t*>(buffer.data()), keystream.data() + keyIndex, bytesRead);
+        keyIndex = (keyIndex + bytesRead) % keySize;
+        crc32 = CRC32::update(crc32, reinterpret_cast<const uint8_t*>(buffer.data()), bytesRead);
         // 写入解密后的数据
         outFile.write(buffer.data(), bytesRead);
     }
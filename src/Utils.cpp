@@ -1,5 +1,6 @@
 // Copyright [2025] <JiJun Lu, Linru Zhou>
 #include "Utils.h"
+#include "CopyEngine.h"
 // 构建一个读写的辅助函数
 bool ReadFile(const std::string& filePath, std::vector<char>& buffer) {
     // 以二进制进行文件读写
@@ -40,26 +41,15 @@ bool WriteFile(const std::string& filePath, const std::vector<char>& buffer) {
 
 
 bool CopyFileBinary(const std::string& srcPath, const std::string& destPath) {
-    // 以二进制进行文件读写
-    std::ifstream inFile(srcPath, std::ios::binary);
-    // 检查文件是否打开成功
-    if (!inFile.is_open()) {
+    // 由复制引擎优先在内核内复制（支持时直接克隆数据块），不再把整个文件读入内存
+    std::error_code ec;
+    uint64_t fileSize = fs::file_size(srcPath, ec);
+    if (ec) {
         std::cerr << "Failed to open file: " << srcPath << std::endl;
         return false;
     }
-    // 获取文件大小
-    inFile.seekg(0, std::ifstream::end);   // 移动到文件末尾
-    std::streampos fileSize = inFile.tellg();   // 获取文件大小（当前指针的位置）
-    inFile.seekg(0);               // 移动回文件开头
-    // 读取文件内容
-    std::vector<char> buffer(fileSize);
-    if (!inFile.read(buffer.data(), fileSize)) {  //  后续可以设置分块读取以防止文件过大导致内存不足
-        std::cerr << "Failed to read file: " << srcPath << std::endl;
-        return false;
-    }
-    inFile.close();
-    // 写入文件内容
-    if (!WriteFile(destPath, buffer)) {
+    CopyEngine engine;
+    if (!engine.open(destPath) || !engine.copy(srcPath, 0, fileSize) || !engine.close()) {
         std::cerr << "Failed to write file: " << destPath << std::endl;
         return false;
     }
@@ -92,3 +82,62 @@ bool isPathWritable(const std::string& path) {
     }
     return false;
 }
+
+namespace {
+
+bool isSeparator(char c) {
+    return c == '/' || c == fs::path::preferred_separator;
+}
+
+}  // namespace
+
+bool matchGlob(std::string_view pattern, std::string_view path) {
+    size_t p = 0;
+    size_t s = 0;
+    while (p < pattern.size()) {
+        char c = pattern[p];
+        if (c == '*') {
+            bool crossDirs = p + 1 < pattern.size() && pattern[p + 1] == '*';
+            p += crossDirs ? 2 : 1;
+            // "**/" 也可以匹配零级目录
+            if (crossDirs && p < pattern.size() && isSeparator(pattern[p]) &&
+                matchGlob(pattern.substr(p + 1), path.substr(s))) {
+                return true;
+            }
+            // 依次尝试让 * 吞掉 0、1、2... 个字符，* 不跨越分隔符
+            for (size_t i = s;; ++i) {
+                if (matchGlob(pattern.substr(p), path.substr(i))) return true;
+                if (i == path.size() || (!crossDirs && isSeparator(path[i]))) return false;
+            }
+        }
+        if (s == path.size()) return false;
+        if (c == '?') {
+            if (isSeparator(path[s])) return false;
+        } else if (c != path[s] && !(isSeparator(c) && isSeparator(path[s]))) {
+            return false;
+        }
+        ++p;
+        ++s;
+    }
+    return s == path.size();
+}
+
+bool matchPathPattern(std::string_view pattern, std::string_view path) {
+    if (matchGlob(pattern, path)) return true;
+    // 依次检查各级上级目录
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (isSeparator(path[i]) && i > 0 && matchGlob(pattern, path.substr(0, i))) return true;
+    }
+    return false;
+}
+
+std::string normalizePathPattern(const std::string& pattern) {
+    std::string result = fs::path(pattern).make_preferred().string();
+    while (result.size() >= 2 && result[0] == '.' && isSeparator(result[1])) {
+        result.erase(0, 2);
+    }
+    while (!result.empty() && isSeparator(result.back())) {
+        result.pop_back();
+    }
+    return result;
+}
@@ -139,6 +139,7 @@ struct BackupState {
     int packTypeIndex = 0;               // 打包类型索引
     bool enableCompress = false;         // 是否启用压缩（对应 --compress）
     int compressTypeIndex = 0;           // 压缩类型索引
+    int compressLevel = COMPRESS_DEFAULT_LEVEL;  // 压缩级别（对应 --level）
     bool enableEncrypt = false;          // 是否启用加密（对应 --encrypt）
     int encryptTypeIndex = 0;            // 加密类型索引
     char encryptKey[256] = "";           // 加密密钥（对应 --key）
@@ -238,7 +239,9 @@ static void executeBackup(BackupState& state, CBackupRecorder& recorder) {
                     state.statusIsError = true;
                     return;
                 }
-                config->setCompressionType(compressType).setCompressionEnabled(true);
+                config->setCompressionType(compressType)
+                    .setCompressionLevel(state.compressLevel)
+                    .setCompressionEnabled(true);
             }
 
             // 设置加密（对应 --encrypt 和 --key）
@@ -456,6 +459,9 @@ static void renderBackupTab(BackupState& state, CBackupRecorder& recorder) {
                 compressItems[i] = compressTypes[i].c_str();
             }
             ImGui::Combo("Compress Algorithm", &state.compressTypeIndex, compressItems, static_cast<int>(compressTypes.size()));
+            ImGui::SliderInt("Compression Level", &state.compressLevel, 1, 9);
+            ImGui::SameLine();
+            ImGui::TextDisabled("1 = fastest, 9 = smallest");
             ImGui::Unindent();
         }
 
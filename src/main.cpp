@@ -44,14 +44,17 @@ std::string utf8_to_gbk(const std::string& str) {
 
 // --mode backup --src "F:\courser_project\software_development\testBox\ori_A" --dst "./"
 // --mode recover --dst "./" --to "./restore_repository/ori_A"
+// --mode recover --fn <filename> --to "./restore_repository" --path "ori_A/docs" --path "ori_A/**/*.txt"
 
 static void printHelp() {
     std::cout << "Usage (pseudo CLI):\n"
               << "--mode backup  --src <path> --dst <relative_path> [--include \".*\\.txt\" "
                "--pack <packType>(default: none)\n --compress <compressType>(default: none)   "
+               "--level <1-9>(default: " << COMPRESS_DEFAULT_LEVEL << ", 1 fastest, 9 densest)  "
                "--encrypt <encryptType>(default: none)  "
                "--key <encryptKey>  --desc <description>]\n"
-              << "--mode recover --fn <filename> --to <target_path>\n";
+              << "--mode recover --fn <filename> --to <target_path> "
+               "[--path <relative path or glob, e.g. ori_A/docs or ori_A/**/*.txt>(repeatable)]\n";
 }
 
 
@@ -76,12 +79,14 @@ static int runParsed(const std::vector<std::string>& args) {
     std::string mode;
     std::string packType = "none";  // 新增加一个参数用于指定打包算法,默认不打包
     std::string compressType = "none";  // 新增加一个参数用于指定压缩算法,默认不压缩
+    std::string compressLevel = std::to_string(COMPRESS_DEFAULT_LEVEL);  // 压缩级别 1-9，1 最快，9 压缩率最高
     std::string encryptType = "none";  // 新增加一个参数用于指定加密算法,默认不加密
     std::string encryptKey;
     std::string srcPath;
     std::string dstPath;
     std::string includeRegex;
     std::string restoreTo;
+    std::vector<std::string> restorePaths;  // 只恢复匹配的文件或目录，可以多次指定
     std::string backupFileName;
     std::string repoPath;
     std::string description = "";  // 新增一个参数用于指定备份行为描述,默认空字符串
@@ -94,12 +99,14 @@ static int runParsed(const std::vector<std::string>& args) {
         } else if (arg == "--pack") { nextVal(i, packType);
         } else if (arg == "--encrypt") { nextVal(i, encryptType);
         } else if (arg == "--compress") { nextVal(i, compressType);
+        } else if (arg == "--level") { nextVal(i, compressLevel);
         } else if (arg == "--key") { nextVal(i, encryptKey);
         } else if (arg == "--src") { nextVal(i, srcPath);
         } else if (arg == "--dst") { nextVal(i, dstPath);
         } else if (arg == "--fn") { nextVal(i, backupFileName);
         } else if (arg == "--include") { nextVal(i, includeRegex);
         } else if (arg == "--to") { nextVal(i, restoreTo);
+        } else if (arg == "--path") { std::string p; if (nextVal(i, p)) restorePaths.push_back(p);
         } else if (arg == "--repo") { nextVal(i, repoPath);
         } else if (arg == "--help" || arg == "-h") { printHelp(); return 0;
         } else if (arg == "--desc") { nextVal(i, description);
@@ -164,9 +171,16 @@ static int runParsed(const std::vector<std::string>& args) {
                         std::cerr << "Error: Compress algorithm type " << compressType << " is not supported.\n";
                         return 1;
                     } else {
-                        // 设置压缩器类型
-                        config->setCompressionType(compressType)
-                                .setCompressionEnabled(true);
+                        // 设置压缩器类型和压缩级别
+                        try {
+                            config->setCompressionType(compressType)
+                                    .setCompressionLevel(std::stoi(compressLevel))
+                                    .setCompressionEnabled(true);
+                        } catch (const std::exception& e) {
+                            std::cerr << "Error: Invalid compression level " << compressLevel
+                                      << " (must be between 1 and 9).\n";
+                            return 1;
+                        }
                     }
                 }
 
@@ -251,7 +265,7 @@ static int runParsed(const std::vector<std::string>& args) {
         }
         // 执行恢复
         CBackup backup;
-        bool success = backup.doRecovery(entry, restoreTo);
+        bool success = backup.doRecovery(entry, restoreTo, std::string(), restorePaths);
         if (!success) {
             std::cerr << "Recovery failed" << std::endl;
             return 2;
@@ -1,5 +1,13 @@
 ﻿  // Copyright [2025] <JiJun Lu, Linru Zhou>
 # include "myPack.h"
+# include "CopyEngine.h"
+# include "CRC32.h"
+# include "ThreadPool.h"
+# include "Utils.h"
+# include <algorithm>
+# include <cstring>
+# include <deque>
+# include <future>
 
 // 定义辅助函数，用于确认文件类型
 FileType getFileType(const std::filesystem::path& path) {
@@ -21,22 +29,55 @@ FileType getFileType(const std::filesystem::path& path) {
 }
 
 
+static_assert(sizeof(PackHead) == 8 && sizeof(PackTocEntry) == 32 && sizeof(PackFooter) == 32,
+              "pack index structures must have a fixed on-disk layout");
+
+namespace {
+
+// 读取线程预先读入的文件内容
+struct PrefetchedFile {
+    bool ok;  // 读取是否成功
+    bool prefetched;  // 内容已读入 data；为false时是大文件，由写入方用复制引擎复制
+    std::vector<char> data;
+};
+
+// 打开并读入一个文件，超过 PACK_PREFETCH_MAX_SIZE 的文件不读入
+PrefetchedFile prefetchFile(const std::filesystem::path& path, uint64_t size) {
+    PrefetchedFile file{true, false, {}};
+    if (size > PACK_PREFETCH_MAX_SIZE) return file;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Failed to open file " << path.string() << " for reading.\n";
+        file.ok = false;
+        return file;
+    }
+    file.data.resize(static_cast<size_t>(size));
+    in.read(file.data.data(), static_cast<std::streamsize>(size));
+    if (static_cast<uint64_t>(in.gcount()) != size) {
+        std::cerr << "Error: Unexpected end of file while reading " << path.string()
+        << " (" << in.gcount() << " of " << size << " bytes).\n";
+        file.ok = false;
+        return file;
+    }
+    file.prefetched = true;
+    return file;
+}
+
+}  // namespace
+
 std::string myPack::pack(const std::vector<std::string>& files, const std::string& destPath) {
     // 首先检查是不是空的文件列表
     if (files.empty())   return "";
 
     std::vector<FileMeta> metas;
-    // 包头长度 = 是否打包（1字节） + 算法类型(1字节) + 文件数量(4字节) + 内容区起始位置(4字节)
-    size_t headerLen = 1 + 1 + 4 + 4;
 
     // 尝试从文件列表中确定根目录
     std::string rootPath = "";
     rootPath = std::filesystem::path(files[0]).parent_path().string();
 
-    // 元数据区长度
-    size_t metaLen = 0;
-    // 记录当前偏移量，初始为内容区起始位置s
-    uint64_t currentOffset = 0;
+    // 记录当前偏移量，文件内容紧接在包头之后
+    uint64_t currentOffset = sizeof(PackHead);
     for (const auto& file : files) {
         // 计算相对于根目录的路径
         std::string relativePath = file;
@@ -54,12 +95,6 @@ std::string myPack::pack(const std::vector<std::string>& files, const std::strin
             }
         }
 
-        metaLen += 4;  // 文件名长度
-        metaLen += relativePath.size();  // 文件名内容
-        metaLen += 8;  // 文件大小
-        metaLen += 8;  // 文件偏移量
-        metaLen += 1;  // 文件类型
-
         // 记录文件类型
         FileType type = getFileType(file);
         // 判断文件大小，目录文件大小为0
@@ -71,7 +106,6 @@ std::string myPack::pack(const std::vector<std::string>& files, const std::strin
         metas.push_back({nameLen, relativePath, size, currentOffset, type});
         currentOffset += size;
     }
-    uint32_t contentStart = headerLen + metaLen;
 
 
     const std::string baseName = "backup_" + std::to_string(time(nullptr)) + "." + getPackTypeName();
@@ -91,42 +125,34 @@ std::string myPack::pack(const std::vector<std::string>& files, const std::strin
     const std::string destPackBase = destPackPath.string();
 
 
-    // 接下来写入包头（包括打包算法，当前包包含的文件数量，文件的元信息）
-    std::ofstream out(destPackBase, std::ios::binary);
-    if (!out) {
-        std::cerr << "Error: Failed to open file " << destPackBase << " for writing.\n";
+    CopyEngine engine;
+    if (!engine.open(destPackBase)) {
         return "";
     }
-    // 写入是否打包（1字节）
-    uint8_t isPacked = 1;
-    out.write(reinterpret_cast<const char*>(&isPacked), sizeof(isPacked));
-
-    // 写入打包算法（1字节）
-    PackType type = PackType::Basic;
-    out.write(reinterpret_cast<const char*>(&type), sizeof(type));
-
-    // 写入当前包包含的文件数量（4字节）
-    uint32_t fileCount = metas.size();
-    out.write(reinterpret_cast<const char*>(&fileCount), sizeof(fileCount));
-
-    // 写入头信息长度（4字节）
-    out.write(reinterpret_cast<const char*>(&contentStart), sizeof(contentStart));
-
-    // 写入文件元信息
-    for (const auto& meta : metas) {
-        out.write(reinterpret_cast<const char*>(&meta.nameLen), sizeof(meta.nameLen));
-        out.write(meta.name.c_str(), meta.nameLen);
-        out.write(reinterpret_cast<const char*>(&meta.size), sizeof(meta.size));
-        out.write(reinterpret_cast<const char*>(&meta.offset), sizeof(meta.offset));
-        out.write(reinterpret_cast<const char*>(&meta.type), sizeof(meta.type));
+    // 失败时删除不完整的包文件
+    auto fail = [&]() {
+        engine.close();
+        std::error_code ec;
+        std::filesystem::remove(destPackBase, ec);
+        return std::string();
+    };
+
+    // 写入包头（打包标志位、打包算法），元信息在文件内容之后写入
+    PackHead head{};
+    head.format = PackFormat::Indexed;
+    head.packType = PackType::Basic;
+    if (!engine.write(0, &head, sizeof(head))) {
+        return fail();
     }
 
     // 写入文件内容（按顺序排列）（这里只写入普通文件的内容）
-    for (const auto& meta : metas) {
+    std::vector<size_t> regular;
+    std::vector<std::filesystem::path> fullPaths;
+    for (size_t i = 0; i < metas.size(); ++i) {
         // 只写入普通文件的内容
-        if (meta.type != FileType::Regular) continue;
+        if (metas[i].type != FileType::Regular) continue;
 
-        std::filesystem::path fullFilePath = std::filesystem::path(rootPath) / meta.name;
+        std::filesystem::path fullFilePath = std::filesystem::path(rootPath) / metas[i].name;
         // 防止路径过长
         // 但是有可能文件路径过长，超过了系统限制
         #ifdef _WIN32
@@ -143,154 +169,380 @@ std::string myPack::pack(const std::vector<std::string>& files, const std::strin
                 fullFilePath = std::filesystem::path(fullPath);
             }
         #endif
+        regular.push_back(i);
+        fullPaths.push_back(fullFilePath);
+    }
 
-        std::ifstream in(fullFilePath, std::ios::binary);
-        if (!in) {
-            std::cerr << "Error: Failed to open file " << fullFilePath.string() << " for reading.\n";
-            return "";
+    // 大文件由复制引擎直接复制到内容区的偏移处，优先在内核内完成，不经过用户态缓冲区；
+    // 元数据中的偏移已按统计时的大小排定，文件在打包过程中变短时无法写出一致的包，复制引擎会报错
+    auto writeFile = [&](size_t k, const PrefetchedFile& file) {
+        const FileMeta& meta = metas[regular[k]];
+        if (!file.ok) return false;
+        if (file.prefetched) return engine.write(meta.offset, file.data.data(), file.data.size());
+        return engine.copy(fullPaths[k], meta.offset, meta.size);
+    };
+
+    // 流水线：读取线程按顺序提前打开并读入后面的小文件，主线程按相同顺序写入包文件，
+    // 在途文件数有上限，每个最多 PACK_PREFETCH_MAX_SIZE 字节；单线程时直接在主线程逐个复制
+    const size_t threads = threadCount == 0 ? ThreadPool::defaultThreadCount() : threadCount;
+    if (threads <= 1 || regular.size() <= 1) {
+        for (size_t k = 0; k < regular.size(); ++k) {
+            if (!writeFile(k, PrefetchedFile{true, false, {}})) return fail();
+        }
+    } else {
+        ThreadPool pool(threads);
+        const size_t maxPending = threads * PACK_PREFETCH_DEPTH;
+        std::deque<std::future<PrefetchedFile>> pending;
+        bool ok = true;
+        size_t written = 0;
+        for (size_t k = 0; k < regular.size() && ok; ++k) {
+            const uint64_t size = metas[regular[k]].size;
+            pending.push_back(pool.submit([path = fullPaths[k], size]() { return prefetchFile(path, size); }));
+            if (pending.size() >= maxPending) {
+                ok = writeFile(written++, pending.front().get());
+                pending.pop_front();
+            }
+        }
+        // 已提交的读取任务必须全部完成后才能返回
+        while (!pending.empty()) {
+            PrefetchedFile file = pending.front().get();
+            pending.pop_front();
+            ok = ok && writeFile(written++, file);
         }
-        std::vector<char> buffer(meta.size);
-        in.read(buffer.data(), meta.size);
-        out.write(buffer.data(), meta.size);
+        if (!ok) return fail();
     }
 
-    out.close();
+    // 写入名字区、按路径排序的目录索引和 PackFooter
+    std::vector<size_t> order(metas.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return metas[a].name < metas[b].name; });
+    std::string names;
+    std::vector<PackTocEntry> toc(metas.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const FileMeta& meta = metas[order[i]];
+        toc[i] = PackTocEntry{};
+        toc[i].nameOffset = names.size();
+        toc[i].nameLen = meta.nameLen;
+        toc[i].type = meta.type;
+        toc[i].size = meta.size;
+        toc[i].dataOffset = meta.offset;
+        names += meta.name;
+    }
+    PackFooter footer{};
+    footer.namesOffset = currentOffset;
+    footer.tocOffset = currentOffset + names.size();
+    footer.entryCount = toc.size();
+    footer.magic = PACK_INDEX_MAGIC;
+    std::string index = names;
+    index.append(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(PackTocEntry));
+    footer.crc32 = CRC32::calculate(reinterpret_cast<const uint8_t*>(index.data()), index.size());
+    index.append(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    if (!engine.write(footer.namesOffset, index.data(), index.size())) {
+        return fail();
+    }
+
+    if (!engine.close()) {
+        std::cerr << "Error: Failed to write file " << destPackBase << ".\n";
+        return fail();
+    }
     std::cout << "Packing " << files.size() << " files to "
     << destPackBase << " using " << getPackTypeName() << "Packer.\n";
     return destPackBase;
 }
 
 bool myPack::unpack(const std::string& srcPath, const std::string& destDir) {
+    // 读取目录（两种格式），条目按路径排序，父目录总在其中的文件之前
+    PackIndex index;
+    if (!index.load(srcPath)) {
+        return false;
+    }
+    const size_t fileCount = index.size();
+    std::cout << "Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << ".\n";
+
+    std::ifstream in(srcPath, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Failed to open file " << srcPath << " for reading.\n";
+        return false;
+    }
+
+    // 遍历构建目录结构，根据不同文件类型区分进行构建
+    for (size_t i = 0; i < fileCount; ++i) {
+        if (!extractEntry(in, srcPath, index.get(i), destDir)) {
+            return false;
+        }
+    }
+
+    in.close();
+    std::cout << "Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << " using BasicPacker.\n";
+    return true;
+}
+
+bool myPack::unpack(const std::string& srcPath, const std::string& destDir,
+                    const std::vector<std::string>& patterns) {
+    PackIndex index;
+    if (!index.load(srcPath)) {
+        return false;
+    }
+
+    // 只在目录索引中查找，匹配的条目按路径排序，父目录仍在其中的文件之前
+    const std::vector<size_t> matched = index.match(patterns);
+    if (matched.empty()) {
+        std::cerr << "Error: No entries in " << srcPath << " match the requested paths.\n";
+        return false;
+    }
+    std::cout << "Unpacking " << matched.size() << " of " << index.size() << " files from " << srcPath
+    << " to " << destDir << ".\n";
+
+    std::ifstream in(srcPath, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Failed to open file " << srcPath << " for reading.\n";
+        return false;
+    }
+    for (size_t i : matched) {
+        if (!extractEntry(in, srcPath, index.get(i), destDir)) {
+            return false;
+        }
+    }
+    in.close();
+    return true;
+}
+
+bool myPack::extractEntry(std::ifstream& in, const std::string& srcPath, const FileMeta& meta,
+                          const std::string& destDir) {
+    switch (meta.type) {
+        // 普通文件
+        case FileType::Regular: {
+            // 定位到对应的文件内容offset
+            in.seekg(meta.offset, std::ios::beg);
+            // 写入
+            std::filesystem::path outPath = std::filesystem::path(destDir) / meta.name;
+            // 但是有可能文件路径过长，超过了系统限制
+            // 参考：https://learn.microsoft.com/zh-cn/windows/win32/fileio/maximum-file-path-limitation?tabs=registry
+            #ifdef _WIN32
+                std::string fullPath = outPath.string();
+                if (fullPath.size() > PATH_MAX) {
+                    // 为本地路径添加 \\?\ 前缀
+                    if (fullPath.compare(0, 2, "\\\\") != 0) {
+                        fullPath = "\\\\?\\" + fullPath;
+                    } else {
+                        // 为UNC路径添加 \\?\UNC\ 前缀
+                        fullPath = "\\\\?\\UNC\\" + fullPath.substr(2);
+                    }
+                    // 使用带有长路径前缀的路径重新创建filesystem::path对象
+                    outPath = std::filesystem::path(fullPath);
+                }
+            #endif
+
+            // 确保目标目录存在
+            if (!std::filesystem::exists(outPath.parent_path())) {
+                // 输出目录路径
+                std::cout << "Unpacking directory " << meta.name << " to " << outPath.parent_path() << ".\n";
+                std::filesystem::create_directories(outPath.parent_path());
+            }
+
+            std::ofstream out(outPath, std::ios::binary);
+
+            if (!out) {
+                std::cerr << "Error: Failed to open file " << outPath << " for writing.\n";
+                return false;
+            }
+
+            size_t remainingSize = meta.size;
+
+            // 合理性检查：如果文件大小异常大，记录警告
+            if (meta.size > 1024 * 1024 * 1024) {   // 大于1GB
+                std::cerr << "Warning: Unexpectedly large file size ("
+                << meta.size << ") for " << meta.name << ".\n";
+            }
+
+            std::vector<char> buffer(std::min<size_t>(PACK_BUFFER_SIZE, remainingSize));
+            while (remainingSize > 0) {
+                size_t toRead = std::min(buffer.size(), remainingSize);
+                in.read(buffer.data(), toRead);
+                size_t bytesRead = in.gcount();
+                if (bytesRead == 0) {
+                    std::cerr << "Error: Unexpected end of file while reading " << meta.name << ".\n";
+                    return false;
+                }
+                out.write(buffer.data(), bytesRead);
+                remainingSize -= bytesRead;
+            }
+            out.close();
+            break;
+        }
+
+        // 目录文件
+        case FileType::Directory: {
+            // 构建目录
+            std::filesystem::path outPath = std::filesystem::path(destDir) / meta.name;
+
+            // 选择性解包时上级目录可能不在解包范围内，一并创建
+            std::error_code ec;
+            std::filesystem::create_directories(outPath, ec);
+            if (!std::filesystem::is_directory(outPath)) {
+                std::cerr << "Error: Failed to create directory " << outPath << ".\n";
+                return false;
+            }
+            break;
+        }
+
+        default: {
+            std::cerr << "Error: Unknown file type " << static_cast<int>(meta.type) << " in " << srcPath << ".\n";
+            break;
+        }
+    }
+    return true;
+}
+
+bool PackIndex::load(const std::string& srcPath) {
+    entries.clear();
+    names.clear();
     std::ifstream in(srcPath, std::ios::binary);
     if (!in) {
         std::cerr << "Error: Failed to open file " << srcPath << " for reading.\n";
         return false;
     }
+    std::error_code ec;
+    const uint64_t fileSize = std::filesystem::file_size(srcPath, ec);
 
-    // 检查是否是打包文件
-    uint8_t isPacked;
+    // 检查是否是打包文件，第一个字节为格式
+    uint8_t isPacked = 0;
+    PackType type = PackType::Basic;
     in.read(reinterpret_cast<char*>(&isPacked), sizeof(isPacked));
-    if (isPacked != 1) {
+    in.read(reinterpret_cast<char*>(&type), sizeof(type));
+    if (!in || ec || (isPacked != static_cast<uint8_t>(PackFormat::Inline) &&
+                      isPacked != static_cast<uint8_t>(PackFormat::Indexed))) {
         // 不是打包文件，返回错误信息
         std::cerr << "Error: File " << srcPath << " is not packed.\n";
         return false;
     }
-
-    // 读取包头
-    // 读取打包算法类型(1字节)
-    PackType type;
-    in.read(reinterpret_cast<char*>(&type), sizeof(type));
     if (type != PackType::Basic) {
         // 匹配失败，返回错误信息
         std::cerr << "Error: Packing algorithm type in " << srcPath << " is not Basic.\n";
         return false;
     }
 
-    // 读取文件数量（4字节）
-    uint32_t fileCount;
-    in.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
-    std::vector<FileMeta> metas(fileCount);
-    std::cout << "Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << ".\n";
+    format = static_cast<PackFormat>(isPacked);
+    bool ok = format == PackFormat::Indexed ? loadIndexed(in, fileSize) : loadInline(in, fileSize);
+    if (!ok) {
+        std::cerr << "Error: Invalid pack index in " << srcPath << ".\n";
+        entries.clear();
+        names.clear();
+    }
+    return ok;
+}
+
+bool PackIndex::loadIndexed(std::ifstream& in, uint64_t fileSize) {
+    // 从文件末尾读取索引位置，再一次读入名字区和定长的目录索引
+    PackFooter footer;
+    if (fileSize < sizeof(PackHead) + sizeof(PackFooter)) return false;
+    in.seekg(static_cast<std::streamoff>(fileSize - sizeof(PackFooter)), std::ios::beg);
+    in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+    const uint64_t tocEnd = fileSize - sizeof(PackFooter);
+    if (!in || footer.magic != PACK_INDEX_MAGIC || footer.namesOffset < sizeof(PackHead) ||
+        footer.namesOffset > footer.tocOffset || footer.tocOffset > tocEnd ||
+        footer.entryCount != (tocEnd - footer.tocOffset) / sizeof(PackTocEntry) ||
+        (tocEnd - footer.tocOffset) % sizeof(PackTocEntry) != 0) {
+        return false;
+    }
+
+    std::string index(static_cast<size_t>(tocEnd - footer.namesOffset), '\0');
+    in.seekg(static_cast<std::streamoff>(footer.namesOffset), std::ios::beg);
+    in.read(&index[0], static_cast<std::streamsize>(index.size()));
+    if (!in || CRC32::calculate(reinterpret_cast<const uint8_t*>(index.data()), index.size()) != footer.crc32) {
+        return false;
+    }
+    const size_t namesSize = static_cast<size_t>(footer.tocOffset - footer.namesOffset);
+    names = index.substr(0, namesSize);
+    entries.resize(static_cast<size_t>(footer.entryCount));
+    std::memcpy(entries.data(), index.data() + namesSize, entries.size() * sizeof(PackTocEntry));
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const PackTocEntry& entry = entries[i];
+        if (entry.nameOffset > names.size() || entry.nameLen > names.size() - entry.nameOffset ||
+            entry.dataOffset < sizeof(PackHead) || entry.dataOffset > footer.namesOffset ||
+            entry.size > footer.namesOffset - entry.dataOffset || (i > 0 && nameOf(i) < nameOf(i - 1))) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    // 读取头信息长度（4字节）
-    uint32_t contentStart;
+bool PackIndex::loadInline(std::ifstream& in, uint64_t fileSize) {
+    // 旧格式：逐条解析包头中的元信息，偏移转换为包文件中的偏移后按路径排序
+    uint32_t fileCount = 0;
+    uint32_t contentStart = 0;
+    in.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
     in.read(reinterpret_cast<char*>(&contentStart), sizeof(contentStart));
+    if (!in || contentStart > fileSize) return false;
 
-    // 读取文件元信息
-    for (auto& meta : metas) {
+    std::vector<FileMeta> metas;
+    for (uint32_t i = 0; i < fileCount; ++i) {
+        FileMeta meta;
         in.read(reinterpret_cast<char*>(&meta.nameLen), sizeof(meta.nameLen));
+        if (!in || meta.nameLen > contentStart) return false;
         meta.name.resize(meta.nameLen);
         in.read(&meta.name[0], meta.nameLen);
         in.read(reinterpret_cast<char*>(&meta.size), sizeof(meta.size));
         in.read(reinterpret_cast<char*>(&meta.offset), sizeof(meta.offset));
         in.read(reinterpret_cast<char*>(&meta.type), sizeof(meta.type));
+        if (!in) return false;
+        meta.offset += contentStart;
+        metas.push_back(std::move(meta));
     }
+    std::stable_sort(metas.begin(), metas.end(), [](const FileMeta& a, const FileMeta& b) { return a.name < b.name; });
+
+    entries.resize(metas.size());
+    for (size_t i = 0; i < metas.size(); ++i) {
+        entries[i] = PackTocEntry{};
+        entries[i].nameOffset = names.size();
+        entries[i].nameLen = metas[i].nameLen;
+        entries[i].type = metas[i].type;
+        entries[i].size = metas[i].size;
+        entries[i].dataOffset = metas[i].offset;
+        names += metas[i].name;
+    }
+    return true;
+}
 
-    // 遍历构建目录结构，根据不同文件类型区分进行构建
-    for (const auto& meta : metas) {
-        switch (meta.type) {
-            // 普通文件
-            case FileType::Regular: {
-                // 定义到对应的文件内容offset（必须是当前流位置开始，也就是元数据区末尾）
-                in.seekg(meta.offset + contentStart, std::ios::beg);
-                // 写入
-                std::filesystem::path outPath = std::filesystem::path(destDir) / meta.name;
-                // 但是有可能文件路径过长，超过了系统限制
-                // 参考：https://learn.microsoft.com/zh-cn/windows/win32/fileio/maximum-file-path-limitation?tabs=registry
-                #ifdef _WIN32
-                    std::string fullPath = outPath.string();
-                    if (fullPath.size() > PATH_MAX) {
-                        // 为本地路径添加 \\?\ 前缀
-                        if (fullPath.compare(0, 2, "\\\\") != 0) {
-                            fullPath = "\\\\?\\" + fullPath;
-                        } else {
-                            // 为UNC路径添加 \\?\UNC\ 前缀
-                            fullPath = "\\\\?\\UNC\\" + fullPath.substr(2);
-                        }
-                        // 使用带有长路径前缀的路径重新创建filesystem::path对象
-                        outPath = std::filesystem::path(fullPath);
-                    }
-                #endif
-
-                // 确保目标目录存在
-                if (!std::filesystem::exists(outPath.parent_path())) {
-                    // 输出目录路径
-                    std::cout << "Unpacking directory " << meta.name << " to " << outPath.parent_path() << ".\n";
-                    std::filesystem::create_directories(outPath.parent_path());
-                }
-
-                std::ofstream out(outPath, std::ios::binary);
-
-                if (!out) {
-                    std::cerr << "Error: Failed to open file " << outPath << " for writing.\n";
-                    return false;
-                }
-
-                const size_t MAX_BUFFER_SIZE = 1024 * 1024;  // 1MB
-                size_t remainingSize = meta.size;
-
-                // 合理性检查：如果文件大小异常大，记录警告
-                if (meta.size > 1024 * 1024 * 1024) {   // 大于1GB
-                    std::cerr << "Warning: Unexpectedly large file size ("
-                    << meta.size << ") for " << meta.name << ".\n";
-                }
-
-                std::vector<char> buffer(std::min(MAX_BUFFER_SIZE, remainingSize));
-                while (remainingSize > 0) {
-                    size_t toRead = std::min(buffer.size(), remainingSize);
-                    in.read(buffer.data(), toRead);
-                    size_t bytesRead = in.gcount();
-                    if (bytesRead == 0) {
-                        std::cerr << "Error: Unexpected end of file while reading " << meta.name << ".\n";
-                        return false;
-                    }
-                    out.write(buffer.data(), bytesRead);
-                    remainingSize -= bytesRead;
-                }
-                out.close();
-                break;
-            }
+FileMeta PackIndex::get(size_t i) const {
+    const PackTocEntry& entry = entries[i];
+    return FileMeta{entry.nameLen, std::string(nameOf(i)), entry.size, entry.dataOffset, entry.type};
+}
 
-            // 目录文件
-            case FileType::Directory: {
-                // 构建目录
-                std::filesystem::path outPath = std::filesystem::path(destDir) / meta.name;
+size_t PackIndex::find(std::string_view name) const {
+    size_t i = lowerBound(name);
+    return i < entries.size() && nameOf(i) == name ? i : entries.size();
+}
 
-                if (!std::filesystem::create_directory(outPath)) {
-                    std::cerr << "Error: Failed to create directory " << outPath << ".\n";
-                    return false;
-                }
-                break;
-            }
+size_t PackIndex::lowerBound(std::string_view name) const {
+    // 条目按路径排序，二分查找
+    size_t low = 0;
+    size_t high = entries.size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (nameOf(mid) < name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
 
-            default: {
-                std::cerr << "Error: Unknown file type " << static_cast<int>(meta.type) << " in " << srcPath << ".\n";
-                break;
+std::vector<size_t> PackIndex::match(const std::vector<std::string>& patterns) const {
+    std::vector<size_t> result;
+    for (const std::string& raw : patterns) {
+        const std::string pattern = normalizePathPattern(raw);
+        // 匹配的路径都以第一个通配符之前的字面前缀开头，在排序后的条目中是连续的一段
+        const std::string_view prefix = std::string_view(pattern).substr(0, pattern.find_first_of("*?"));
+        for (size_t i = lowerBound(prefix); i < entries.size() && nameOf(i).substr(0, prefix.size()) == prefix; ++i) {
+            if (matchPathPattern(pattern, nameOf(i))) {
+                result.push_back(i);
             }
         }
     }
-
-    in.close();
-    std::cout << "Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << " using BasicPacker.\n";
-    return true;
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
 }
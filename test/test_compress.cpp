@@ -1,6 +1,8 @@
 ﻿#include <gtest/gtest.h>
 
 #include "HuffmanCompress.h"  // 包含您的压缩功能头文件
+#include "LZ77Compress.h"
+#include "CompressFactory.h"
 
 #include <fstream>
 #include <filesystem>
@@ -112,6 +114,55 @@ TEST(CompressionTest, CRC32Check) {
     CleanupTestFile(compressedFile);
 }
 
+// 新增：按块计算的CRC32（slicing-by-16 查表及运行时选择的硬件实现）与逐字节计算一致
+TEST(CompressionTest, CRC32BlockUpdateMatchesBytewise) {
+    std::cout << "CRC32 implementation: " << CRC32::getImplementationName() << std::endl;
+    const std::string check = "123456789";
+    EXPECT_EQ(CRC32::calculate(reinterpret_cast<const uint8_t*>(check.data()), check.size()), 0xCBF43926u);
+
+    std::vector<uint8_t> data(1000);
+    uint32_t seed = 1;
+    for (auto& byte : data) {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    // 不同的起始偏移和长度（覆盖不足16字节的尾部、硬件实现的64字节下限和4路折叠之后的余数）
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t size : {0u, 1u, 15u, 16u, 17u, 31u, 63u, 64u, 65u, 100u, 128u, 191u, 977u}) {
+            uint32_t expected = CRC32::getInitialValue();
+            for (size_t i = 0; i < size; ++i) expected = CRC32::update(expected, data[offset + i]);
+            EXPECT_EQ(CRC32::updateTable(CRC32::getInitialValue(), data.data() + offset, size), expected)
+                << offset << " " << size;
+            EXPECT_EQ(CRC32::update(CRC32::getInitialValue(), data.data() + offset, size), expected)
+                << offset << " " << size;
+        }
+    }
+}
+
+// 新增：分段计算的CRC32可以合并为整段数据的CRC32
+TEST(CompressionTest, CRC32Combine) {
+    std::vector<uint8_t> data((1 << 20) + 37);
+    uint32_t seed = 3;
+    for (auto& byte : data) {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    const uint32_t whole = CRC32::calculate(data);
+    for (size_t split : {size_t{0}, size_t{1}, size_t{1000}, data.size() / 2, data.size() - 1, data.size()}) {
+        uint32_t crcA = CRC32::calculate(data.data(), split);
+        uint32_t crcB = CRC32::calculate(data.data() + split, data.size() - split);
+        EXPECT_EQ(CRC32::combine(crcA, crcB, data.size() - split), whole) << split;
+    }
+
+    // 多段按顺序合并
+    uint32_t combined = 0;
+    for (size_t pos = 0; pos < data.size(); pos += 65536) {
+        size_t size = std::min<size_t>(65536, data.size() - pos);
+        combined = CRC32::combine(combined, CRC32::calculate(data.data() + pos, size), size);
+    }
+    EXPECT_EQ(combined, whole);
+}
+
 // 新增：超大文件（100MB）压缩/解压测试
 TEST(CompressionTest, LargeFileCompressionDecompression) {
     const std::string sourceFile = "test_large.txt";
@@ -158,4 +209,573 @@ TEST(CompressionTest, LargeFileCompressionDecompression) {
     CleanupTestFile(sourceFile);
     CleanupTestFile(compressedFile);
     CleanupTestFile(decompressedFile);
-}
\ No newline at end of file
+}
+
+// 新增：查表解码与逐位解码结果一致（含超过查表位数的长编码）
+TEST(CompressionTest, TableDecodeMatchesBitByBit) {
+    const std::string sourceFile = "test_table_decode.bin";
+    const std::string tableFile = "test_table_decode_table.bin";
+    const std::string bitFile = "test_table_decode_bit.bin";
+
+    // 按斐波那契数列分配词频，使哈夫曼编码长度超过 HUFF_TABLE_BITS
+    std::string content;
+    uint64_t a = 1, b = 1;
+    for (int sym = 0; sym < 24; ++sym) {
+        content.append(static_cast<size_t>(a), static_cast<char>('A' + sym));
+        uint64_t next = a + b;
+        a = b;
+        b = next;
+    }
+    // 打乱顺序，避免连续的相同字节
+    for (size_t i = 0; i < content.size(); ++i) {
+        std::swap(content[i], content[(i * 7919) % content.size()]);
+    }
+
+    CleanupTestFile(sourceFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content)) << "Failed to create test file";
+
+    HuffmanCompress huffmanCompressor;
+    std::string compressedFile = huffmanCompressor.compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty()) << "Compression failed";
+
+    huffmanCompressor.setDecodeMode(HuffmanDecodeMode::Table);
+    ASSERT_TRUE(huffmanCompressor.decompressFile(compressedFile, tableFile)) << "Table decode failed";
+    huffmanCompressor.setDecodeMode(HuffmanDecodeMode::BitByBit);
+    ASSERT_TRUE(huffmanCompressor.decompressFile(compressedFile, bitFile)) << "Bit-by-bit decode failed";
+
+    std::vector<char> tableContent, bitContent;
+    ASSERT_TRUE(ReadTestFile(tableFile, tableContent));
+    ASSERT_TRUE(ReadTestFile(bitFile, bitContent));
+    EXPECT_EQ(std::string(tableContent.begin(), tableContent.end()), content);
+    EXPECT_EQ(tableContent, bitContent);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(tableFile);
+    CleanupTestFile(bitFile);
+}
+
+// 新增：CRC校验失败时删除或隔离不完整的输出文件
+TEST(CompressionTest, CorruptOutputDeletedOrQuarantined) {
+    const std::string sourceFile = "test_corrupt_source.txt";
+    const std::string decompressedFile = "test_corrupt_decompressed.txt";
+    const std::string quarantineFile = decompressedFile + ".corrupt";
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decompressedFile);
+    CleanupTestFile(quarantineFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, "Streaming decompression with CRC failure handling"));
+
+    HuffmanCompress huffmanCompressor;
+    std::string compressedFile = huffmanCompressor.compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty()) << "Compression failed";
+
+    // 篡改文件头中的CRC32
+    {
+        std::fstream file(compressedFile, std::ios::binary | std::ios::in | std::ios::out);
+        ASSERT_TRUE(file.is_open());
+        uint32_t badCRC = 0xDEADBEEF;
+        file.seekp(offsetof(Head, crc32), std::ios::beg);
+        file.write(reinterpret_cast<const char*>(&badCRC), sizeof(badCRC));
+    }
+
+    // 默认删除输出
+    EXPECT_FALSE(huffmanCompressor.decompressFile(compressedFile, decompressedFile));
+    EXPECT_FALSE(std::filesystem::exists(decompressedFile)) << "Partial output should be deleted";
+
+    // 隔离模式下保留为 .corrupt 文件
+    huffmanCompressor.setCorruptOutputPolicy(CorruptOutputPolicy::Quarantine);
+    EXPECT_FALSE(huffmanCompressor.decompressFile(compressedFile, decompressedFile));
+    EXPECT_FALSE(std::filesystem::exists(decompressedFile));
+    EXPECT_TRUE(std::filesystem::exists(quarantineFile)) << "Partial output should be quarantined";
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(quarantineFile);
+}
+
+// 新增：旧格式（词频表）压缩文件仍可解压
+TEST(CompressionTest, LegacyFreqTableFormatReadable) {
+    const std::string legacyFile = "test_legacy.huff";
+    const std::string decompressedFile = "test_legacy_decompressed.txt";
+    const std::string content = "aab";
+
+    // 手工构造旧格式文件："a"词频2，"b"词频1，树为 (b, a)，编码 b=0 a=1
+    Head header;
+    header.isCompress = 0x21;
+    header.compressType = CompressType::Huffman;
+    header.validBits = 5;  // 只有3位有效
+    header.version = static_cast<uint8_t>(HuffmanFormat::FreqTable);
+    header.headerSize = sizeof(Head);
+    header.freqTableSize = 2 * (1 + 8);
+    header.originalSize = content.size();
+    header.crc32 = CRC32::calculate(std::vector<uint8_t>(content.begin(), content.end()));
+    {
+        std::ofstream out(legacyFile, std::ios::binary);
+        ASSERT_TRUE(out.is_open());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
+        const uint8_t symbols[2] = {'a', 'b'};
+        const uint64_t freqs[2] = {2, 1};
+        for (int i = 0; i < 2; ++i) {
+            out.write(reinterpret_cast<const char*>(&symbols[i]), 1);
+            out.write(reinterpret_cast<const char*>(&freqs[i]), 8);
+        }
+        const uint8_t data = 0xC0;  // 1 1 0
+        out.write(reinterpret_cast<const char*>(&data), 1);
+    }
+
+    HuffmanCompress huffmanCompressor;
+    ASSERT_TRUE(huffmanCompressor.decompressFile(legacyFile, decompressedFile)) << "Legacy decode failed";
+    std::vector<char> decompressedContent;
+    ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+    EXPECT_EQ(std::string(decompressedContent.begin(), decompressedContent.end()), content);
+
+    CleanupTestFile(legacyFile);
+    CleanupTestFile(decompressedFile);
+}
+
+// 新增：交错格式（4个位流）的块在两种解码方式下都能还原
+TEST(CompressionTest, InterleavedBlockStreams) {
+    // 各种长度的块，包括不足4个字节、不能被4整除的情况
+    for (size_t size : {2u, 3u, 5u, 7u, 1000u, 4099u, 65537u}) {
+        std::vector<uint8_t> input(size);
+        for (size_t i = 0; i < size; ++i) input[i] = static_cast<uint8_t>("aaaabbbcccdddeeefghijklmnop"[i % 27]);
+        HuffmanCompress::EncodedBlock block = HuffmanCompress::encodeBlock(input);
+        HuffBlockEntry entry{0, static_cast<uint32_t>(size), static_cast<uint32_t>(block.data.size()),
+                             block.crc32, block.stored ? HUFF_BLOCK_STORED : 0u};
+        for (HuffmanDecodeMode mode : {HuffmanDecodeMode::Table, HuffmanDecodeMode::BitByBit}) {
+            std::vector<uint8_t> output;
+            EXPECT_TRUE(HuffmanCompress::decodeBlock(block.data, entry, mode, output)) << size;
+            EXPECT_EQ(output, input) << size;
+        }
+    }
+
+    // 压缩文件使用分块格式
+    const std::string sourceFile = "test_interleaved_source.txt";
+    const std::string decompressedFile = "test_interleaved_decompressed.txt";
+    std::string content;
+    for (int i = 0; i < 30000; ++i) content += "interleaved stream " + std::to_string(i % 113) + "\n";
+    CleanupTestFile(sourceFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+    HuffmanCompress huffmanCompressor;
+    std::string compressedFile = huffmanCompressor.compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty());
+    {
+        std::ifstream in(compressedFile, std::ios::binary);
+        Head header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(Head));
+        EXPECT_EQ(header.version, static_cast<uint8_t>(HuffmanFormat::Blocked));
+    }
+
+    ASSERT_TRUE(huffmanCompressor.decompressFile(compressedFile, decompressedFile));
+    std::vector<char> decompressedContent;
+    ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+    EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(decompressedFile);
+}
+
+// 新增：分块格式多线程压缩/解压
+TEST(CompressionTest, BlockParallelRoundTrip) {
+    const std::string sourceFile = "test_block_source.bin";
+    const std::string decompressedFile = "test_block_decompressed.bin";
+
+    // 生成多个块、每块分布不同的数据（最后一块不满）
+    std::string content;
+    for (size_t block = 0; block < 9; ++block) {
+        for (size_t i = 0; i < (size_t{1} << 16) - 1000 * block; ++i) {
+            content.push_back(static_cast<char>('a' + (i * (block + 1)) % (3 + block * 20)));
+        }
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decompressedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    HuffmanCompress huffmanCompressor;
+    huffmanCompressor.setBlockSize(1 << 16);
+    huffmanCompressor.setThreadCount(4);
+    std::string compressedFile = huffmanCompressor.compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty()) << "Block compression failed";
+
+    // 检查块索引
+    {
+        std::ifstream in(compressedFile, std::ios::binary);
+        Head header;
+        HuffBlockIndexHead indexHead;
+        in.read(reinterpret_cast<char*>(&header), sizeof(Head));
+        in.read(reinterpret_cast<char*>(&indexHead), sizeof(HuffBlockIndexHead));
+        EXPECT_EQ(header.version, static_cast<uint8_t>(HuffmanFormat::Blocked));
+        EXPECT_EQ(indexHead.blockCount, (content.size() + (1 << 16) - 1) / (1 << 16));
+    }
+
+    for (auto mode : {HuffmanDecodeMode::Table, HuffmanDecodeMode::BitByBit}) {
+        huffmanCompressor.setDecodeMode(mode);
+        ASSERT_TRUE(huffmanCompressor.decompressFile(compressedFile, decompressedFile)) << "Block decompression failed";
+        std::vector<char> decompressedContent;
+        ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+        EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+    }
+
+    // 单线程时在主线程内编码，输出与多线程一致
+    std::vector<char> parallelOutput;
+    ASSERT_TRUE(ReadTestFile(compressedFile, parallelOutput));
+    huffmanCompressor.setThreadCount(1);
+    ASSERT_EQ(huffmanCompressor.compressFile(sourceFile), compressedFile);
+    std::vector<char> inlineOutput;
+    ASSERT_TRUE(ReadTestFile(compressedFile, inlineOutput));
+    EXPECT_TRUE(inlineOutput == parallelOutput);
+    // 单线程解压同样在主线程内解码
+    for (auto mode : {HuffmanDecodeMode::Table, HuffmanDecodeMode::BitByBit}) {
+        huffmanCompressor.setDecodeMode(mode);
+        ASSERT_TRUE(huffmanCompressor.decompressFile(compressedFile, decompressedFile));
+        std::vector<char> decompressedContent;
+        ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+        EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+    }
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(decompressedFile);
+}
+
+// 新增：LZ77压缩/解压，覆盖重复数据、重叠匹配、不可压缩块和跨块数据
+TEST(CompressionTest, LZ77RoundTrip) {
+    const std::string sourceFile = "test_lz77_source.bin";
+    const std::string decompressedFile = "test_lz77_decompressed.bin";
+
+    std::string content;
+    for (int i = 0; i < 40000; ++i) {
+        content += "2025-01-01 backup file_" + std::to_string(i % 97) + " ok\n";
+    }
+    content += std::string(100000, 'z');  // 重叠匹配
+    uint32_t seed = 12345;
+    for (int i = 0; i < (1 << 20); ++i) {  // 不可压缩数据
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decompressedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    auto compressor = CompressFactory::createCompress("LZ77");
+    ASSERT_NE(compressor, nullptr);
+    std::string compressedFile = compressor->compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty()) << "LZ77 compression failed";
+    EXPECT_TRUE(CompressFactory::isCompressedFile(compressedFile));
+    EXPECT_EQ(CompressFactory::getCompressType(compressedFile), "LZ77");
+    EXPECT_LT(std::filesystem::file_size(compressedFile), content.size());
+
+    ASSERT_TRUE(compressor->decompressFile(compressedFile, decompressedFile)) << "LZ77 decompression failed";
+    std::vector<char> decompressedContent;
+    ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+    EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(decompressedFile);
+}
+
+// 新增：LZ77块解码器拒绝损坏的数据
+TEST(CompressionTest, LZ77RejectsCorruptBlock) {
+    std::string text;
+    for (int i = 0; i < 1000; ++i) text += "abcabcabd";
+    std::vector<uint8_t> compressed;
+    size_t size = LZ77Compress::compressBlock(reinterpret_cast<const uint8_t*>(text.data()), text.size(), compressed);
+    ASSERT_LT(size, text.size());
+
+    std::vector<uint8_t> output(text.size());
+    ASSERT_TRUE(LZ77Compress::decompressBlock(compressed.data(), size, output.data(), output.size()));
+    EXPECT_EQ(std::memcmp(output.data(), text.data(), text.size()), 0);
+
+    // 截断或输出大小不符都应失败
+    EXPECT_FALSE(LZ77Compress::decompressBlock(compressed.data(), size - 1, output.data(), output.size()));
+    EXPECT_FALSE(LZ77Compress::decompressBlock(compressed.data(), size, output.data(), output.size() - 1));
+    // 第一个序列的匹配偏移指向输出起点之前
+    std::vector<uint8_t> bad = {0x10, 'a', 0x05, 0x00, 0x00};
+    EXPECT_FALSE(LZ77Compress::decompressBlock(bad.data(), bad.size(), output.data(), 10));
+}
+
+// 新增：压缩级别影响LZ77和Huffman的参数，各级别都能正确解压
+TEST(CompressionTest, CompressionLevelTradeOffs) {
+    const std::string sourceFile = "test_level_source.txt";
+    const std::string decompressedFile = "test_level_decompressed.txt";
+
+    std::string content;
+    uint32_t seed = 7;
+    for (int i = 0; i < 60000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        content += "user" + std::to_string((seed >> 16) % 500) + " read block " + std::to_string((seed >> 8) % 64) + "\n";
+    }
+    CleanupTestFile(sourceFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    LZ77Compress lz;
+    uintmax_t sizes[2] = {0, 0};
+    int levels[2] = {1, 9};
+    for (int i = 0; i < 2; ++i) {
+        lz.setCompressionLevel(levels[i]);
+        std::string compressedFile = lz.compressFile(sourceFile);
+        ASSERT_FALSE(compressedFile.empty());
+        sizes[i] = std::filesystem::file_size(compressedFile);
+        ASSERT_TRUE(lz.decompressFile(compressedFile, decompressedFile)) << "Level " << levels[i];
+        std::vector<char> decompressedContent;
+        ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+        EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+        CleanupTestFile(compressedFile);
+        CleanupTestFile(decompressedFile);
+    }
+    EXPECT_LT(sizes[1], sizes[0]) << "Level 9 should compress better than level 1";
+
+    // 超出范围的级别取最近的合法值
+    lz.setCompressionLevel(42);
+    EXPECT_EQ(lz.getCompressionLevel(), COMPRESS_MAX_LEVEL);
+
+    HuffmanCompress huffman;
+    huffman.setCompressionLevel(1);
+    EXPECT_LT(huffman.getBlockSize(), static_cast<size_t>(HUFF_DEFAULT_BLOCK_SIZE));
+    huffman.setCompressionLevel(9);
+    EXPECT_GT(huffman.getBlockSize(), static_cast<size_t>(HUFF_DEFAULT_BLOCK_SIZE));
+
+    CleanupTestFile(sourceFile);
+}
+
+// 新增：编码表 + 64位位写入器的输出能被查表解码器还原
+TEST(CompressionTest, EncodeTableMatchesDecodeTable) {
+    // 构造一组前缀码：符号 i (i < 15) 编码为 i 个1后跟一个0，符号15为15个1
+    std::array<std::vector<bool>, 256> codes;
+    for (int sym = 0; sym < 16; ++sym) {
+        codes[sym].assign(sym, true);
+        if (sym < 15) codes[sym].push_back(false);
+    }
+    HuffmanEncodeTable encodeTable;
+    HuffmanDecodeTable decodeTable;
+    ASSERT_TRUE(encodeTable.build(codes));
+    ASSERT_TRUE(decodeTable.build(codes));
+    EXPECT_EQ(encodeTable[3].code, 0xEu);
+    EXPECT_EQ(encodeTable[3].len, 4);
+
+    std::vector<uint8_t> input;
+    for (int i = 0; i < 10000; ++i) input.push_back(static_cast<uint8_t>((i * 7 + i / 13) % 16));
+    std::vector<uint8_t> encoded(input.size() * 2);
+    HuffmanBitWriter writer(encoded.data());
+    encodeTable.encode(input.data(), input.size(), writer);
+    encoded.resize(writer.finish());
+
+    HuffmanBitReader reader(encoded.data(), encoded.size());
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(decodeTable.decode(reader, input.size(), [&decoded](uint8_t byte) { decoded.push_back(byte); }));
+    EXPECT_TRUE(decoded == input);
+}
+
+// 新增：内存压缩/解压接口，结果与文件接口格式相同
+TEST(CompressionTest, InMemoryCompressDecompress) {
+    const std::string sourceFile = "test_memory_source.txt";
+    const std::string decompressedFile = "test_memory_decompressed.txt";
+
+    std::string content;
+    for (int i = 0; i < 30000; ++i) {
+        content += "line " + std::to_string(i % 1000) + ": in-memory pipeline stage\n";
+    }
+    const std::vector<char> source(content.begin(), content.end());
+    CleanupTestFile(sourceFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    for (const std::string& type : CompressFactory::getSupportedCompressTypes()) {
+        auto compressor = CompressFactory::createCompress(type);
+        std::vector<char> compressed;
+        ASSERT_TRUE(compressor->compressData(source, compressed)) << type;
+        EXPECT_LT(compressed.size(), source.size()) << type;
+
+        std::vector<char> restored;
+        ASSERT_TRUE(compressor->decompressData(compressed, restored)) << type;
+        EXPECT_TRUE(restored == source) << type;
+
+        // 内存结果可以按文件解压，文件结果也可以按内存解压
+        std::string compressedFile = compressor->compressFile(sourceFile);
+        ASSERT_FALSE(compressedFile.empty()) << type;
+        std::vector<char> fileBytes;
+        ASSERT_TRUE(ReadTestFile(compressedFile, fileBytes));
+        EXPECT_TRUE(fileBytes == compressed) << type;
+        ASSERT_TRUE(compressor->decompressData(fileBytes, restored)) << type;
+        EXPECT_TRUE(restored == source) << type;
+        CleanupTestFile(compressedFile);
+
+        // 损坏的数据解压失败，输出为空
+        compressed[compressed.size() / 2] ^= 0x5A;
+        EXPECT_FALSE(compressor->decompressData(compressed, restored)) << type;
+        EXPECT_TRUE(restored.empty()) << type;
+        std::vector<char> garbage(100, 'x');
+        EXPECT_FALSE(compressor->decompressData(garbage, restored)) << type;
+    }
+
+    // 空数据
+    HuffmanCompress huffman;
+    std::vector<char> empty, compressed, restored;
+    ASSERT_TRUE(huffman.compressData(empty, compressed));
+    ASSERT_TRUE(huffman.decompressData(compressed, restored));
+    EXPECT_TRUE(restored.empty());
+
+    // 头中的原始大小被改为极大值时返回false，而不是按它分配内存
+    auto corruptOriginalSize = [&source](ICompress& compressor, size_t offset) {
+        std::vector<char> data;
+        if (!compressor.compressData(source, data)) return false;
+        const uint64_t hugeSize = uint64_t{1} << 50;
+        std::memcpy(data.data() + offset, &hugeSize, sizeof(hugeSize));
+        std::vector<char> output;
+        return !compressor.decompressData(data, output) && output.empty();
+    };
+    LZ77Compress lz77;
+    EXPECT_TRUE(corruptOriginalSize(huffman, offsetof(Head, originalSize)));
+    EXPECT_TRUE(corruptOriginalSize(lz77, offsetof(LZHead, originalSize)));
+
+    // 块大小超过 COMPRESS_MAX_BLOCK_SIZE 的头直接拒绝
+    std::vector<char> lzData;
+    ASSERT_TRUE(lz77.compressData(source, lzData));
+    const uint32_t hugeBlock = 1u << 30;
+    std::memcpy(lzData.data() + offsetof(LZHead, blockSize), &hugeBlock, sizeof(hugeBlock));
+    EXPECT_FALSE(lz77.decompressData(lzData, restored));
+
+    CleanupTestFile(sourceFile);
+}
+
+// 新增：不可压缩的块原样存储，文件不会因压缩而明显变大
+TEST(CompressionTest, IncompressibleBlocksStoredRaw) {
+    const std::string sourceFile = "test_stored_source.bin";
+    const std::string decompressedFile = "test_stored_decompressed.bin";
+    const size_t blockSize = 1 << 16;
+
+    // 随机数据块、文本块、随机数据块
+    std::string content;
+    uint32_t seed = 99;
+    auto appendRandom = [&]() {
+        for (size_t i = 0; i < blockSize; ++i) {
+            seed = seed * 1103515245 + 12345;
+            content.push_back(static_cast<char>(seed >> 24));
+        }
+    };
+    appendRandom();
+    for (size_t i = 0; i < blockSize; ++i) content.push_back("aaaabbc"[i % 7]);
+    appendRandom();
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decompressedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    HuffmanCompress huffmanCompressor;
+    huffmanCompressor.setBlockSize(blockSize);
+    std::string compressedFile = huffmanCompressor.compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty());
+
+    {
+        std::ifstream in(compressedFile, std::ios::binary);
+        Head header;
+        HuffBlockIndexHead indexHead;
+        in.read(reinterpret_cast<char*>(&header), sizeof(Head));
+        in.read(reinterpret_cast<char*>(&indexHead), sizeof(HuffBlockIndexHead));
+        ASSERT_EQ(indexHead.blockCount, 3u);
+        std::vector<HuffBlockEntry> entries(indexHead.blockCount);
+        in.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(HuffBlockEntry));
+        EXPECT_EQ(entries[0].flags, HUFF_BLOCK_STORED);
+        EXPECT_EQ(entries[1].flags, 0u);
+        EXPECT_EQ(entries[2].flags, HUFF_BLOCK_STORED);
+        EXPECT_EQ(entries[0].compressedSize, blockSize);
+    }
+    EXPECT_LT(std::filesystem::file_size(compressedFile), content.size());
+
+    ASSERT_TRUE(huffmanCompressor.decompressFile(compressedFile, decompressedFile));
+    std::vector<char> decompressedContent;
+    ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+    EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(decompressedFile);
+}
+
+// 新增：FSE对概率偏斜的数据压缩率优于整数位码长的Huffman，RLE块和原样存储的块也能正确还原
+TEST(CompressionTest, FSERoundTrip) {
+    const std::string sourceFile = "test_fse_source.bin";
+    const std::string decompressedFile = "test_fse_decompressed.bin";
+
+    // 约90%为同一字节的数据，Huffman每个符号至少1位，FSE接近信息熵
+    std::string content;
+    uint32_t seed = 7;
+    for (int i = 0; i < (1 << 20); ++i) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t r = (seed >> 16) % 100;
+        content.push_back(r < 90 ? 'a' : static_cast<char>('b' + r % 6));
+    }
+    content += std::string(FSE_DEFAULT_BLOCK_SIZE, 'z');  // RLE块
+    for (int i = 0; i < 100000; ++i) {  // 不可压缩数据
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decompressedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    auto compressor = CompressFactory::createCompress("FSE");
+    ASSERT_NE(compressor, nullptr);
+    std::string compressedFile = compressor->compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty()) << "FSE compression failed";
+    EXPECT_TRUE(CompressFactory::isCompressedFile(compressedFile));
+    EXPECT_EQ(CompressFactory::getCompressType(compressedFile), "FSE");
+
+    HuffmanCompress huffmanCompressor;
+    std::string huffmanFile = huffmanCompressor.compressFile(sourceFile);
+    ASSERT_FALSE(huffmanFile.empty());
+    EXPECT_LT(std::filesystem::file_size(compressedFile), std::filesystem::file_size(huffmanFile));
+
+    ASSERT_TRUE(compressor->decompressFile(compressedFile, decompressedFile)) << "FSE decompression failed";
+    std::vector<char> decompressedContent;
+    ASSERT_TRUE(ReadTestFile(decompressedFile, decompressedContent));
+    EXPECT_TRUE(std::string(decompressedContent.begin(), decompressedContent.end()) == content);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(huffmanFile);
+    CleanupTestFile(decompressedFile);
+}
+
+// 新增：FSE块解码器拒绝损坏的数据
+TEST(CompressionTest, FSERejectsCorruptBlock) {
+    std::string text;
+    for (int i = 0; i < 5000; ++i) text += "aaaaaaabbbc";
+    std::vector<uint8_t> compressed;
+    size_t size = FSECompress::compressBlock(reinterpret_cast<const uint8_t*>(text.data()), text.size(), compressed);
+    ASSERT_GT(size, 0u);
+    ASSERT_LT(size, text.size());
+
+    std::vector<uint8_t> output(text.size());
+    ASSERT_TRUE(FSECompress::decompressBlock(compressed.data(), size, output.data(), output.size()));
+    EXPECT_EQ(std::memcmp(output.data(), text.data(), text.size()), 0);
+
+    // 截断、输出大小不符、归一化计数总和错误都应失败
+    EXPECT_FALSE(FSECompress::decompressBlock(compressed.data(), size - 1, output.data(), output.size()));
+    EXPECT_FALSE(FSECompress::decompressBlock(compressed.data(), size, output.data(), output.size() - 1));
+    std::vector<uint8_t> bad(compressed.begin(), compressed.begin() + size);
+    bad[2 + 2 * 'a'] ^= 1;
+    EXPECT_FALSE(FSECompress::decompressBlock(bad.data(), bad.size(), output.data(), output.size()));
+
+    // 文件头中的原始大小被改为极大值时返回false，而不是按它分配内存
+    FSECompress fse;
+    std::vector<char> data;
+    ASSERT_TRUE(fse.compressData(std::vector<char>(text.begin(), text.end()), data));
+    const uint64_t hugeSize = uint64_t{1} << 50;
+    std::memcpy(data.data() + offsetof(FSEHead, originalSize), &hugeSize, sizeof(hugeSize));
+    std::vector<char> restored;
+    EXPECT_FALSE(fse.decompressData(data, restored));
+    EXPECT_TRUE(restored.empty());
+
+    // 块大小超过上限、未知的格式版本都应失败
+    ASSERT_TRUE(fse.compressData(std::vector<char>(text.begin(), text.end()), data));
+    std::vector<char> badBlock = data;
+    const uint32_t hugeBlock = 1u << 30;
+    std::memcpy(badBlock.data() + offsetof(FSEHead, blockSize), &hugeBlock, sizeof(hugeBlock));
+    EXPECT_FALSE(fse.decompressData(badBlock, restored));
+    std::vector<char> badVersion = data;
+    badVersion[offsetof(FSEHead, version)] = FSE_FORMAT_VERSION + 1;
+    EXPECT_FALSE(fse.decompressData(badVersion, restored));
+    ASSERT_TRUE(fse.decompressData(data, restored));
+}
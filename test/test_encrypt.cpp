@@ -1,12 +1,20 @@
 #include <gtest/gtest.h>
 
 #include "SimpleXOREncrypt.h"  // 包含您的加密功能头文件
+#include "AESEncrypt.h"
+#include "ChaCha20Encrypt.h"
+#include "EncryptFactory.h"
+#include "Poly1305.h"
+#include "SHA256.h"
 
 #include <fstream>
 #include <filesystem>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <cstring>
+#include <memory>
+#include <random>
 #include "testUtils.h"
 
 // 测试用例：测试基本的加密和解密功能
@@ -115,4 +123,452 @@ TEST(EncryptionTest, LongKeyEncryptionDecryption) {
     CleanupTestFile(sourceFile);
     CleanupTestFile(encryptedPath);
     CleanupTestFile(decryptedFile);
-}
\ No newline at end of file
+}
+// 新增：向量化的异或实现与逐字节按密钥循环异或的结果完全一致（跨越多个缓冲区、密钥长度不整除缓冲区大小）
+TEST(EncryptionTest, VectorizedXorMatchesBytewise) {
+    std::cout << "XOR kernel: " << SimpleXOREncrypt::getKernelName() << std::endl;
+    const std::string sourceFile = "test_xor_source.bin";
+    const std::string decryptedFile = "test_xor_decrypted.bin";
+    const std::string key = "Key#7ab";
+
+    std::string content;
+    uint32_t seed = 5;
+    for (int i = 0; i < 3 * BUFFER_SIZE + 1234; ++i) {
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decryptedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    SimpleXOREncrypt encryptor;
+    std::string encryptedPath = encryptor.encryptFile(sourceFile, key);
+    ASSERT_FALSE(encryptedPath.empty());
+    std::vector<char> encrypted;
+    ASSERT_TRUE(ReadTestFile(encryptedPath, encrypted));
+    ASSERT_EQ(encrypted.size(), sizeof(EncHead) + content.size());
+    for (size_t i = 0; i < content.size(); ++i) {
+        ASSERT_EQ(encrypted[sizeof(EncHead) + i], static_cast<char>(content[i] ^ key[i % key.size()])) << i;
+    }
+
+    ASSERT_TRUE(encryptor.decryptFile(encryptedPath, decryptedFile, key));
+    std::vector<char> decrypted;
+    ASSERT_TRUE(ReadTestFile(decryptedFile, decrypted));
+    EXPECT_TRUE(std::string(decrypted.begin(), decrypted.end()) == content);
+
+    // 各种长度的尾部
+    std::vector<uint8_t> keystream(600), data(600), expected(600);
+    for (size_t i = 0; i < 600; ++i) {
+        keystream[i] = static_cast<uint8_t>(i * 7 + 1);
+        data[i] = static_cast<uint8_t>(i * 13);
+    }
+    for (size_t size : {0u, 1u, 15u, 63u, 64u, 127u, 255u, 256u, 599u}) {
+        std::vector<uint8_t> buffer(data.begin(), data.begin() + size);
+        SimpleXOREncrypt::xorKeystream(buffer.data(), keystream.data(), size);
+        for (size_t i = 0; i < size; ++i) ASSERT_EQ(buffer[i], data[i] ^ keystream[i]) << size;
+    }
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(encryptedPath);
+    CleanupTestFile(decryptedFile);
+}
+
+// 新增：SHA-256 / PBKDF2 标准测试向量（FIPS 180-4 "abc"，RFC 7914 第11节 PBKDF2-HMAC-SHA256）
+TEST(EncryptionTest, SHA256AndPBKDF2KnownAnswer) {
+    auto hex = [](const uint8_t* data, size_t size) {
+        static const char* digits = "0123456789abcdef";
+        std::string s;
+        for (size_t i = 0; i < size; ++i) {
+            s.push_back(digits[data[i] >> 4]);
+            s.push_back(digits[data[i] & 0xF]);
+        }
+        return s;
+    };
+    const std::string abc = "abc";
+    SHA256::Digest digest = SHA256::hash(reinterpret_cast<const uint8_t*>(abc.data()), abc.size());
+    EXPECT_EQ(hex(digest.data(), digest.size()), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    // 分段输入与一次输入结果相同
+    std::string longText(1000, 'a');
+    SHA256 sha;
+    sha.update(reinterpret_cast<const uint8_t*>(longText.data()), 63);
+    sha.update(reinterpret_cast<const uint8_t*>(longText.data()) + 63, longText.size() - 63);
+    EXPECT_TRUE(sha.finish() == SHA256::hash(reinterpret_cast<const uint8_t*>(longText.data()), longText.size()));
+
+    const std::string salt = "salt";
+    uint8_t derived[64];
+    SHA256::pbkdf2("passwd", reinterpret_cast<const uint8_t*>(salt.data()), salt.size(), 1, derived, sizeof(derived));
+    EXPECT_EQ(hex(derived, sizeof(derived)),
+              "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+              "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783");
+}
+
+// 新增：AES-256 标准测试向量（FIPS 197 附录C.3，SP 800-38A F.5.5 CTR-AES256），硬件实现与查表实现结果一致
+TEST(EncryptionTest, AES256KnownAnswer) {
+    std::cout << "AES implementation: " << AES256::getImplementationName() << std::endl;
+    auto fromHex = [](const std::string& s) {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; i + 1 < s.size(); i += 2) {
+            bytes.push_back(static_cast<uint8_t>(std::stoi(s.substr(i, 2), nullptr, 16)));
+        }
+        return bytes;
+    };
+
+    std::vector<uint8_t> key(32);
+    for (size_t i = 0; i < key.size(); ++i) key[i] = static_cast<uint8_t>(i);
+    AES256 aes(key.data());
+    std::vector<uint8_t> plain = fromHex("00112233445566778899aabbccddeeff");
+    uint8_t cipher[16];
+    aes.encryptBlock(plain.data(), cipher);
+    EXPECT_TRUE(std::vector<uint8_t>(cipher, cipher + 16) == fromHex("8ea2b7ca516745bfeafc49904b496089"));
+
+    // 计数器块 f0f1...ff：nonce 为前8字节，起始块号为后8字节
+    AES256 ctr(fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4").data());
+    const std::vector<uint8_t> nonce = fromHex("f0f1f2f3f4f5f6f7");
+    const uint64_t counter = 0xf8f9fafbfcfdfeffull;
+    std::vector<uint8_t> data = fromHex(
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+    const std::vector<uint8_t> expected = fromHex(
+        "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+        "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6");
+    std::vector<uint8_t> portable = data;
+    ctr.ctrXor(nonce.data(), counter, data.data(), data.size());
+    ctr.ctrXorPortable(nonce.data(), counter, portable.data(), portable.size());
+    EXPECT_TRUE(data == expected);
+    EXPECT_TRUE(portable == expected);
+
+    // 覆盖8块并行路径、逐块路径和不足一个分组的尾部
+    std::vector<uint8_t> buffer(1000);
+    for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<uint8_t>(i * 31 + 7);
+    for (size_t size : {0u, 5u, 16u, 127u, 128u, 129u, 300u, 1000u}) {
+        std::vector<uint8_t> a(buffer.begin(), buffer.begin() + size);
+        std::vector<uint8_t> b = a;
+        ctr.ctrXor(nonce.data(), 41, a.data(), size);
+        ctr.ctrXorPortable(nonce.data(), 41, b.data(), size);
+        ASSERT_TRUE(a == b) << size;
+    }
+}
+
+// 新增：AES加密文件的加解密、工厂创建、错误密码检测
+TEST(EncryptionTest, AESFileRoundTrip) {
+    const std::string sourceFile = "test_aes_source.bin";
+    const std::string decryptedFile = "test_aes_decrypted.bin";
+    const std::string key = "AesKey!2025";
+
+    std::string content;
+    uint32_t seed = 11;
+    for (int i = 0; i < 2 * CIPHER_BUFFER_SIZE + 777; ++i) {
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decryptedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    ASSERT_TRUE(EncryptFactory::isEncryptTypeSupported("AES"));
+    std::unique_ptr<IEncrypt> encryptor = EncryptFactory::createEncryptor("AES");
+    ASSERT_NE(encryptor, nullptr);
+    EXPECT_EQ(encryptor->getEncryptType(), EncryptType::AES);
+    std::string encryptedPath = encryptor->encryptFile(sourceFile, key);
+    ASSERT_FALSE(encryptedPath.empty());
+    EXPECT_TRUE(EncryptFactory::isFileEncrypted(encryptedPath));
+    EXPECT_EQ(EncryptFactory::getEncryptType(encryptedPath), "AES");
+
+    std::vector<char> encrypted;
+    ASSERT_TRUE(ReadTestFile(encryptedPath, encrypted));
+    const size_t chunkCount = (content.size() + CIPHER_CHUNK_SIZE - 1) / CIPHER_CHUNK_SIZE;
+    const size_t dataOffset = sizeof(CipherEncHead) + sizeof(CipherChunkHead) + chunkCount * sizeof(CipherChunkEntry);
+    ASSERT_EQ(encrypted.size(), dataOffset + content.size());
+    CipherEncHead head;
+    std::memcpy(&head, encrypted.data(), sizeof(head));
+    EXPECT_EQ(head.version, CIPHER_FORMAT_VERSION);
+    EXPECT_FALSE(std::equal(content.begin(), content.begin() + 64, encrypted.begin() + dataOffset));
+
+    ASSERT_TRUE(encryptor->decryptFile(encryptedPath, decryptedFile, key));
+    std::vector<char> decrypted;
+    ASSERT_TRUE(ReadTestFile(decryptedFile, decrypted));
+    EXPECT_TRUE(std::string(decrypted.begin(), decrypted.end()) == content);
+
+    EXPECT_FALSE(encryptor->decryptFile(encryptedPath, decryptedFile, "WrongKey"));
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(encryptedPath);
+    CleanupTestFile(decryptedFile);
+}
+
+// 新增：ChaCha20 标准测试向量（RFC 8439 2.3.2 / 2.4.2），向量实现与标量实现结果一致
+TEST(EncryptionTest, ChaCha20KnownAnswer) {
+    std::cout << "ChaCha20 implementation: " << ChaCha20::getImplementationName() << std::endl;
+    auto fromHex = [](const std::string& s) {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; i + 1 < s.size(); i += 2) {
+            bytes.push_back(static_cast<uint8_t>(std::stoi(s.substr(i, 2), nullptr, 16)));
+        }
+        return bytes;
+    };
+    std::vector<uint8_t> key(32);
+    for (size_t i = 0; i < key.size(); ++i) key[i] = static_cast<uint8_t>(i);
+    ChaCha20 chacha(key.data());
+
+    // RFC 的96位 nonce 为 n0 || n1 || n2、32位块计数 c，对应这里的64位块计数 c | (n0 << 32) 与 nonce n1 || n2
+    std::vector<uint8_t> block(64, 0);
+    chacha.xorKeystream(fromHex("0000004a00000000").data(), 0x0900000000000001ull, block.data(), block.size());
+    EXPECT_TRUE(block == fromHex(
+        "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+        "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e"));
+
+    const std::string plain = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                              "for the future, sunscreen would be it.";
+    std::vector<uint8_t> data(plain.begin(), plain.end());
+    chacha.xorKeystream(fromHex("0000004a00000000").data(), 1, data.data(), data.size());
+    EXPECT_TRUE(data == fromHex(
+        "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+        "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+        "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+        "5af90bbf74a35be6b40b8eedf2785e42874d"));
+
+    // 覆盖8块、4块、逐块和不足一块的尾部，块计数跨越32位边界
+    const std::vector<uint8_t> nonce = fromHex("0102030405060708");
+    std::vector<uint8_t> buffer(2000);
+    for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<uint8_t>(i * 29 + 3);
+    for (size_t size : {0u, 1u, 64u, 255u, 256u, 257u, 512u, 800u, 2000u}) {
+        std::vector<uint8_t> a(buffer.begin(), buffer.begin() + size);
+        std::vector<uint8_t> b = a;
+        chacha.xorKeystream(nonce.data(), 0xFFFFFFFDull, a.data(), size);
+        chacha.xorKeystreamPortable(nonce.data(), 0xFFFFFFFDull, b.data(), size);
+        ASSERT_TRUE(a == b) << size;
+    }
+}
+
+// 新增：ChaCha20 加密文件的加解密、工厂创建、错误密码检测
+TEST(EncryptionTest, ChaCha20FileRoundTrip) {
+    const std::string sourceFile = "test_chacha_source.bin";
+    const std::string decryptedFile = "test_chacha_decrypted.bin";
+    const std::string key = "ChaChaKey";
+
+    std::string content;
+    uint32_t seed = 19;
+    for (int i = 0; i < CIPHER_BUFFER_SIZE + 4321; ++i) {
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decryptedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    std::unique_ptr<IEncrypt> encryptor = EncryptFactory::createEncryptor("ChaCha20");
+    ASSERT_NE(encryptor, nullptr);
+    EXPECT_EQ(encryptor->getEncryptType(), EncryptType::ChaCha20);
+    std::string encryptedPath = encryptor->encryptFile(sourceFile, key);
+    ASSERT_FALSE(encryptedPath.empty());
+    EXPECT_EQ(EncryptFactory::getEncryptType(encryptedPath), "ChaCha20");
+
+    // AES 解密器拒绝 ChaCha20 文件
+    AESEncrypt aes;
+    EXPECT_FALSE(aes.decryptFile(encryptedPath, decryptedFile, key));
+
+    ASSERT_TRUE(encryptor->decryptFile(encryptedPath, decryptedFile, key));
+    std::vector<char> decrypted;
+    ASSERT_TRUE(ReadTestFile(decryptedFile, decrypted));
+    EXPECT_TRUE(std::string(decrypted.begin(), decrypted.end()) == content);
+
+    EXPECT_FALSE(encryptor->decryptFile(encryptedPath, decryptedFile, "WrongKey"));
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(encryptedPath);
+    CleanupTestFile(decryptedFile);
+}
+
+// 新增：Poly1305 标准测试向量（RFC 8439 2.5.2）
+TEST(EncryptionTest, Poly1305KnownAnswer) {
+    auto fromHex = [](const std::string& s) {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; i + 1 < s.size(); i += 2) {
+            bytes.push_back(static_cast<uint8_t>(std::stoi(s.substr(i, 2), nullptr, 16)));
+        }
+        return bytes;
+    };
+    const std::vector<uint8_t> key = fromHex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b");
+    const std::string message = "Cryptographic Forum Research Group";
+    Poly1305::Tag tag = Poly1305::mac(key.data(), reinterpret_cast<const uint8_t*>(message.data()), message.size());
+    EXPECT_EQ(std::vector<uint8_t>(tag.begin(), tag.end()), fromHex("a8061dc1305136c6c22b8baf0c0127a9"));
+
+    // 分段追加与一次计算结果相同
+    Poly1305 poly(key.data());
+    poly.update(reinterpret_cast<const uint8_t*>(message.data()), 5);
+    poly.update(reinterpret_cast<const uint8_t*>(message.data()) + 5, 20);
+    poly.update(reinterpret_cast<const uint8_t*>(message.data()) + 25, message.size() - 25);
+    EXPECT_EQ(poly.finish(), tag);
+}
+
+// 新增：分块格式的随机读取与篡改检测
+TEST(EncryptionTest, ChunkedRandomAccessAndTamper) {
+    const std::string sourceFile = "test_chunked_source.bin";
+    const std::string decryptedFile = "test_chunked_decrypted.bin";
+    const std::string key = "ChunkKey";
+
+    std::string content;
+    uint32_t seed = 23;
+    for (int i = 0; i < 3 * CIPHER_CHUNK_SIZE + 999; ++i) {
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decryptedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    for (const std::string type : {"AES", "ChaCha20"}) {
+        std::unique_ptr<IEncrypt> encryptor = EncryptFactory::createEncryptor(type);
+        auto* cipher = dynamic_cast<CipherEncrypt*>(encryptor.get());
+        ASSERT_NE(cipher, nullptr);
+        std::string encryptedPath = cipher->encryptFile(sourceFile, key);
+        ASSERT_FALSE(encryptedPath.empty());
+
+        // 随机偏移读取，包括跨越分块边界的读取
+        std::unique_ptr<CipherReader> reader = cipher->openReader(encryptedPath, key);
+        ASSERT_NE(reader, nullptr);
+        EXPECT_EQ(reader->size(), content.size());
+        std::mt19937 rng(7);
+        std::vector<uint8_t> out;
+        for (int i = 0; i < 20; ++i) {
+            uint64_t offset = rng() % content.size();
+            size_t size = std::min<uint64_t>(rng() % (CIPHER_CHUNK_SIZE + 1000), content.size() - offset);
+            out.resize(size);
+            ASSERT_TRUE(reader->read(offset, out.data(), size));
+            EXPECT_EQ(std::memcmp(out.data(), content.data() + offset, size), 0) << type << " offset " << offset;
+        }
+        out.resize(100);
+        ASSERT_TRUE(reader->read(CIPHER_CHUNK_SIZE - 50, out.data(), out.size()));
+        EXPECT_EQ(std::memcmp(out.data(), content.data() + CIPHER_CHUNK_SIZE - 50, out.size()), 0);
+        EXPECT_FALSE(reader->read(content.size() - 10, out.data(), 11));
+        reader.reset();
+
+        // 密码错误时第一块就无法通过认证
+        std::unique_ptr<CipherReader> wrong = cipher->openReader(encryptedPath, "WrongKey");
+        ASSERT_NE(wrong, nullptr);
+        EXPECT_FALSE(wrong->read(0, out.data(), 1));
+
+        // 篡改第2块的一个字节：整体解密失败，其他分块仍可读取
+        const size_t chunkCount = (content.size() + CIPHER_CHUNK_SIZE - 1) / CIPHER_CHUNK_SIZE;
+        const size_t dataOffset =
+            sizeof(CipherEncHead) + sizeof(CipherChunkHead) + chunkCount * sizeof(CipherChunkEntry);
+        {
+            std::fstream file(encryptedPath, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekg(dataOffset + 2 * CIPHER_CHUNK_SIZE + 12345);
+            char c = 0;
+            file.read(&c, 1);
+            c ^= 0x01;
+            file.seekp(dataOffset + 2 * CIPHER_CHUNK_SIZE + 12345);
+            file.write(&c, 1);
+        }
+        EXPECT_FALSE(cipher->decryptFile(encryptedPath, decryptedFile, key));
+        // 认证失败时不留下只含部分明文的输出文件
+        EXPECT_FALSE(std::filesystem::exists(decryptedFile));
+        reader = cipher->openReader(encryptedPath, key);
+        ASSERT_NE(reader, nullptr);
+        ASSERT_TRUE(reader->read(10, out.data(), out.size()));
+        EXPECT_EQ(std::memcmp(out.data(), content.data() + 10, out.size()), 0);
+        EXPECT_FALSE(reader->read(2 * CIPHER_CHUNK_SIZE + 12300, out.data(), out.size()));
+        ASSERT_TRUE(reader->read(3 * CIPHER_CHUNK_SIZE, out.data(), out.size()));
+        EXPECT_EQ(std::memcmp(out.data(), content.data() + 3 * CIPHER_CHUNK_SIZE, out.size()), 0);
+        reader.reset();
+
+        CleanupTestFile(encryptedPath);
+    }
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decryptedFile);
+}
+
+// 新增：旧的单密钥流格式（CipherFormat::Stream）仍可解密
+TEST(EncryptionTest, CipherStreamFormatCompat) {
+    const std::string encryptedFile = "test_stream_v1.enc";
+    const std::string decryptedFile = "test_stream_v1_decrypted.bin";
+    const std::string key = "OldKey";
+    const std::string content(CIPHER_BUFFER_SIZE + 333, 'z');
+
+    CipherEncHead head{};
+    head.isEncrypt = 0x31;
+    head.encryptType = EncryptType::AES;
+    head.version = static_cast<uint16_t>(CipherFormat::Stream);
+    head.headerSize = sizeof(CipherEncHead);
+    head.crc32 = CRC32::finalize(CRC32::update(CRC32::getInitialValue(),
+                                               reinterpret_cast<const uint8_t*>(content.data()), content.size()));
+    head.iterations = 1000;
+    for (int i = 0; i < CIPHER_SALT_SIZE; ++i) head.salt[i] = static_cast<uint8_t>(i);
+    for (int i = 0; i < CIPHER_NONCE_SIZE; ++i) head.nonce[i] = static_cast<uint8_t>(0xa0 + i);
+    uint8_t derived[CIPHER_KEY_SIZE];
+    SHA256::pbkdf2(key, head.salt, CIPHER_SALT_SIZE, head.iterations, derived, sizeof(derived));
+    std::vector<uint8_t> data(content.begin(), content.end());
+    AES256(derived).ctrXor(head.nonce, 0, data.data(), data.size());
+
+    std::string raw(reinterpret_cast<const char*>(&head), sizeof(head));
+    raw.append(data.begin(), data.end());
+    CleanupTestFile(decryptedFile);
+    ASSERT_TRUE(CreateTestFile(encryptedFile, raw));
+
+    AESEncrypt aes;
+    ASSERT_TRUE(aes.decryptFile(encryptedFile, decryptedFile, key));
+    std::vector<char> decrypted;
+    ASSERT_TRUE(ReadTestFile(decryptedFile, decrypted));
+    EXPECT_TRUE(std::string(decrypted.begin(), decrypted.end()) == content);
+    // 旧格式没有分块索引，不支持随机读取
+    EXPECT_EQ(aes.openReader(encryptedFile, key), nullptr);
+
+    // 密码错误时CRC校验失败，与分块格式一样不留下输出文件
+    EXPECT_FALSE(aes.decryptFile(encryptedFile, decryptedFile, "WrongKey"));
+    EXPECT_FALSE(std::filesystem::exists(decryptedFile));
+
+    CleanupTestFile(encryptedFile);
+    CleanupTestFile(decryptedFile);
+}
+
+// 新增：多线程分块加解密与单线程结果互通，各块CRC合并后与整个文件的CRC一致
+TEST(EncryptionTest, CipherParallelChunks) {
+    const std::string sourceFile = "test_parallel_source.bin";
+    const std::string decryptedFile = "test_parallel_decrypted.bin";
+    const std::string key = "ParallelKey";
+
+    std::string content;
+    uint32_t seed = 29;
+    for (int i = 0; i < 9 * CIPHER_CHUNK_SIZE + 12345; ++i) {
+        seed = seed * 1103515245 + 12345;
+        content.push_back(static_cast<char>(seed >> 24));
+    }
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(decryptedFile);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    ChaCha20Encrypt parallel;
+    parallel.setThreadCount(4);
+    ChaCha20Encrypt serial;
+    serial.setThreadCount(1);
+
+    std::string encryptedPath = parallel.encryptFile(sourceFile, key);
+    ASSERT_FALSE(encryptedPath.empty());
+    std::vector<char> encrypted;
+    ASSERT_TRUE(ReadTestFile(encryptedPath, encrypted));
+    CipherEncHead head;
+    std::memcpy(&head, encrypted.data(), sizeof(head));
+    EXPECT_EQ(head.crc32, CRC32::calculate(reinterpret_cast<const uint8_t*>(content.data()), content.size()));
+
+    for (ChaCha20Encrypt* decryptor : {&serial, &parallel}) {
+        ASSERT_TRUE(decryptor->decryptFile(encryptedPath, decryptedFile, key));
+        std::vector<char> decrypted;
+        ASSERT_TRUE(ReadTestFile(decryptedFile, decrypted));
+        EXPECT_TRUE(std::string(decrypted.begin(), decrypted.end()) == content);
+    }
+    EXPECT_FALSE(parallel.decryptFile(encryptedPath, decryptedFile, "WrongKey"));
+
+    // 空文件
+    ASSERT_TRUE(CreateTestFile(sourceFile, ""));
+    encryptedPath = parallel.encryptFile(sourceFile, key);
+    ASSERT_FALSE(encryptedPath.empty());
+    ASSERT_TRUE(serial.decryptFile(encryptedPath, decryptedFile, key));
+    EXPECT_EQ(std::filesystem::file_size(decryptedFile), 0u);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(encryptedPath);
+    CleanupTestFile(decryptedFile);
+}
@@ -3,7 +3,10 @@
 #include "myPack.h"
 #include "testUtils.h"
 #include "CBackup.h"
+#include "CopyEngine.h"
+#include "Utils.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -201,4 +204,308 @@ TEST(myPackTest, LongPathPackUnpack) {
     std::filesystem::remove_all(packDestDir);
     std::filesystem::remove_all(packedFilePath);
     std::filesystem::remove_all(unpackDestDir);
-}
\ No newline at end of file
+}
+// 新增：大于复制缓冲区的文件分段打包/解包后内容一致
+TEST(myPackTest, LargeFilePackUnpack) {
+    const std::string testDir = "test_large_pack_dir";
+    const std::string file1 = testDir + "/large.bin";
+    const std::string file2 = testDir + "/small.txt";
+    const std::string packDestDir = "test_large_pack_dest";
+    const std::string unpackDestDir = "test_large_unpack_dest";
+
+    CleanupTestDir(testDir);
+    CleanupTestDir(packDestDir);
+    CleanupTestDir(unpackDestDir);
+    std::filesystem::create_directories(testDir);
+
+    std::string largeContent;
+    uint32_t seed = 5;
+    for (int i = 0; i < 2 * PACK_BUFFER_SIZE + 321; ++i) {
+        seed = seed * 1103515245 + 12345;
+        largeContent.push_back(static_cast<char>(seed >> 24));
+    }
+    ASSERT_TRUE(CreateTestFile(file1, largeContent));
+    ASSERT_TRUE(CreateTestFile(file2, "small file after the large one"));
+
+    myPack packer;
+    std::string packedFilePath = packer.pack({file1, file2}, packDestDir);
+    ASSERT_FALSE(packedFilePath.empty());
+    std::filesystem::create_directories(unpackDestDir);
+    ASSERT_TRUE(packer.unpack(packedFilePath, unpackDestDir));
+
+    std::vector<char> content1, content2;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/large.bin", content1));
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/small.txt", content2));
+    EXPECT_TRUE(std::string(content1.begin(), content1.end()) == largeContent);
+    EXPECT_EQ(std::string(content2.begin(), content2.end()), "small file after the large one");
+
+    std::filesystem::remove_all(testDir);
+    std::filesystem::remove_all(packDestDir);
+    std::filesystem::remove_all(unpackDestDir);
+}
+
+// 新增：复制引擎按偏移复制多个源文件，源文件过短时失败
+TEST(myPackTest, CopyEngineRanges) {
+    const std::string testDir = "test_copy_engine_dir";
+    const std::string file1 = testDir + "/a.bin";
+    const std::string file2 = testDir + "/b.bin";
+    const std::string dest = testDir + "/dest.bin";
+    CleanupTestDir(testDir);
+    std::filesystem::create_directories(testDir);
+
+    const std::string content1(COPY_BUFFER_SIZE + 77, 'a');
+    const std::string content2 = "second file";
+    ASSERT_TRUE(CreateTestFile(file1, content1));
+    ASSERT_TRUE(CreateTestFile(file2, content2));
+
+    // 整个文件复制
+    ASSERT_TRUE(CopyFileBinary(file1, dest));
+    std::vector<char> copied;
+    ASSERT_TRUE(ReadTestFile(dest, copied));
+    EXPECT_TRUE(std::string(copied.begin(), copied.end()) == content1);
+
+    // 包头 + 两个文件依次排列
+    CopyEngine engine;
+    ASSERT_TRUE(engine.open(dest));
+    ASSERT_TRUE(engine.write(0, "HEAD", 4));
+    ASSERT_TRUE(engine.copy(file1, 4, content1.size()));
+    // 复制到非空目标文件的中间，不能克隆
+    EXPECT_NE(engine.getLastMethod(), CopyMethod::Reflink);
+    ASSERT_TRUE(engine.copy(file2, 4 + content1.size(), content2.size()));
+    // 源文件比记录的大小短
+    EXPECT_FALSE(engine.copy(file2, 4 + content1.size() + content2.size(), content2.size() + 1));
+    ASSERT_TRUE(engine.close());
+    ASSERT_TRUE(ReadTestFile(dest, copied));
+    ASSERT_GE(copied.size(), 4 + content1.size() + content2.size());
+    EXPECT_TRUE(std::string(copied.begin(), copied.begin() + 4 + content1.size() + content2.size()) ==
+                "HEAD" + content1 + content2);
+
+#ifdef __linux__
+    // procfs 文件的 copy_file_range 可能直接返回0，应回退到其他方式，而不是判为源文件过短
+    ASSERT_TRUE(engine.open(dest));
+    ASSERT_TRUE(engine.copy("/proc/self/status", 0, 5));
+    ASSERT_TRUE(engine.close());
+    ASSERT_TRUE(ReadTestFile(dest, copied));
+    EXPECT_EQ(std::string(copied.begin(), copied.end()), "Name:");
+#endif
+
+    std::filesystem::remove_all(testDir);
+}
+
+// 新增：流水线打包（多个读取线程）与逐个读取得到的包内容相同
+TEST(myPackTest, PipelinedPackMatchesSerial) {
+    const std::string testDir = "test_pipeline_pack_dir";
+    const std::string serialDest = "test_pipeline_serial_dest";
+    const std::string parallelDest = "test_pipeline_parallel_dest";
+    const std::string unpackDestDir = "test_pipeline_unpack_dest";
+    CleanupTestDir(testDir);
+    CleanupTestDir(serialDest);
+    CleanupTestDir(parallelDest);
+    CleanupTestDir(unpackDestDir);
+    std::filesystem::create_directories(testDir + "/sub");
+
+    // 大量小文件、空文件和一个超过预读上限的大文件
+    std::vector<std::string> files = {testDir + "/sub"};
+    for (int i = 0; i < 200; ++i) {
+        std::string file = testDir + (i % 2 ? "/sub/f" : "/f") + std::to_string(i) + ".txt";
+        ASSERT_TRUE(CreateTestFile(file, std::string(i * 37, static_cast<char>('a' + i % 26))));
+        files.push_back(file);
+    }
+    ASSERT_TRUE(CreateTestFile(testDir + "/large.bin", std::string(PACK_PREFETCH_MAX_SIZE + 5, 'L')));
+    files.insert(files.begin() + 100, testDir + "/large.bin");
+
+    myPack serial;
+    serial.setThreadCount(1);
+    myPack parallel;
+    parallel.setThreadCount(4);
+    std::string serialPack = serial.pack(files, serialDest);
+    std::string parallelPack = parallel.pack(files, parallelDest);
+    ASSERT_FALSE(serialPack.empty());
+    ASSERT_FALSE(parallelPack.empty());
+
+    std::vector<char> serialContent, parallelContent;
+    ASSERT_TRUE(ReadTestFile(serialPack, serialContent));
+    ASSERT_TRUE(ReadTestFile(parallelPack, parallelContent));
+    EXPECT_TRUE(serialContent == parallelContent);
+
+    std::filesystem::create_directories(unpackDestDir);
+    ASSERT_TRUE(parallel.unpack(parallelPack, unpackDestDir));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/sub/f199.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), std::string(199 * 37, static_cast<char>('a' + 199 % 26)));
+
+    // 读取失败时不留下不完整的包
+    std::filesystem::remove(testDir + "/f100.txt");
+    EXPECT_TRUE(parallel.pack(files, parallelDest + "_missing").empty());
+    EXPECT_TRUE(!std::filesystem::exists(parallelDest + "_missing") ||
+                std::filesystem::is_empty(parallelDest + "_missing"));
+
+    std::filesystem::remove_all(testDir);
+    std::filesystem::remove_all(serialDest);
+    std::filesystem::remove_all(parallelDest);
+    std::filesystem::remove_all(parallelDest + "_missing");
+    std::filesystem::remove_all(unpackDestDir);
+}
+
+// 新增：末尾目录索引按路径排序，可以二分查找任意条目
+TEST(myPackTest, PackIndexLookup) {
+    const std::string testDir = "test_pack_index_dir";
+    const std::string packDestDir = "test_pack_index_dest";
+    CleanupTestDir(testDir);
+    CleanupTestDir(packDestDir);
+    std::filesystem::create_directories(testDir + "/b");
+
+    std::vector<std::string> files = {testDir + "/b"};
+    for (const std::string name : {"z.txt", "b/c.txt", "a.txt", "b/a.txt"}) {
+        ASSERT_TRUE(CreateTestFile(testDir + "/" + name, "content of " + name));
+        files.push_back(testDir + "/" + name);
+    }
+
+    myPack packer;
+    std::string packedFilePath = packer.pack(files, packDestDir);
+    ASSERT_FALSE(packedFilePath.empty());
+
+    PackIndex index;
+    ASSERT_TRUE(index.load(packedFilePath));
+    EXPECT_EQ(index.getFormat(), PackFormat::Indexed);
+    ASSERT_EQ(index.size(), files.size());
+    for (size_t i = 1; i < index.size(); ++i) {
+        EXPECT_LT(index.get(i - 1).name, index.get(i).name);
+    }
+
+    std::vector<char> packed;
+    ASSERT_TRUE(ReadTestFile(packedFilePath, packed));
+    for (const std::string name : {"z.txt", "b/c.txt", "a.txt", "b/a.txt"}) {
+        // 路径相对于第一个文件的父目录
+        const std::string path = std::filesystem::path(name).string();
+        size_t i = index.find(path);
+        ASSERT_LT(i, index.size()) << path;
+        FileMeta meta = index.get(i);
+        EXPECT_EQ(meta.type, FileType::Regular);
+        EXPECT_EQ(std::string(packed.begin() + meta.offset, packed.begin() + meta.offset + meta.size),
+                  "content of " + name);
+    }
+    EXPECT_EQ(index.find("missing.txt"), index.size());
+    ASSERT_LT(index.find("b"), index.size());
+    EXPECT_EQ(index.get(index.find("b")).type, FileType::Directory);
+
+    // 索引被破坏时拒绝读取
+    packed[packed.size() - sizeof(PackFooter) - 1] ^= 0x01;
+    const std::string corrupted = packDestDir + "/corrupted.Basic";
+    ASSERT_TRUE(CreateTestFile(corrupted, std::string(packed.begin(), packed.end())));
+    EXPECT_FALSE(index.load(corrupted));
+
+    std::filesystem::remove_all(testDir);
+    std::filesystem::remove_all(packDestDir);
+}
+
+// 新增：旧格式（元信息在包头）的包仍可解包和查找
+TEST(myPackTest, UnpackInlineFormat) {
+    const std::string packFile = "test_inline_format.Basic";
+    const std::string unpackDestDir = "test_inline_unpack_dest";
+    CleanupTestFile(packFile);
+    CleanupTestDir(unpackDestDir);
+
+    // 目录 d、文件 d/x.txt 和 a.txt，内容按元信息顺序排列
+    struct Entry { std::string name; std::string content; FileType type; };
+    const std::vector<Entry> entries = {
+        {"d", "", FileType::Directory}, {"d/x.txt", "xxx", FileType::Regular}, {"a.txt", "aaaa", FileType::Regular}};
+    std::string metaArea;
+    uint64_t offset = 0;
+    for (const auto& entry : entries) {
+        uint32_t nameLen = entry.name.size();
+        uint64_t size = entry.content.size();
+        metaArea.append(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
+        metaArea += entry.name;
+        metaArea.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        metaArea.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        metaArea.push_back(static_cast<char>(entry.type));
+        offset += size;
+    }
+    std::string raw;
+    raw.push_back(static_cast<char>(PackFormat::Inline));
+    raw.push_back(static_cast<char>(PackType::Basic));
+    uint32_t fileCount = entries.size();
+    uint32_t contentStart = 10 + metaArea.size();
+    raw.append(reinterpret_cast<const char*>(&fileCount), sizeof(fileCount));
+    raw.append(reinterpret_cast<const char*>(&contentStart), sizeof(contentStart));
+    raw += metaArea;
+    for (const auto& entry : entries) raw += entry.content;
+    ASSERT_TRUE(CreateTestFile(packFile, raw));
+
+    PackIndex index;
+    ASSERT_TRUE(index.load(packFile));
+    EXPECT_EQ(index.getFormat(), PackFormat::Inline);
+    ASSERT_LT(index.find("d/x.txt"), index.size());
+    EXPECT_EQ(index.get(index.find("d/x.txt")).offset, contentStart);
+
+    myPack packer;
+    std::filesystem::create_directories(unpackDestDir);
+    ASSERT_TRUE(packer.unpack(packFile, unpackDestDir));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/d/x.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "xxx");
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/a.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "aaaa");
+
+    CleanupTestFile(packFile);
+    std::filesystem::remove_all(unpackDestDir);
+}
+
+// 新增：按路径或通配符只解包部分文件
+TEST(myPackTest, SelectiveUnpack) {
+    EXPECT_TRUE(matchGlob("*.txt", "a.txt"));
+    EXPECT_FALSE(matchGlob("*.txt", "docs/x.txt"));
+    EXPECT_TRUE(matchGlob("**/*.txt", "docs/x.txt"));
+    EXPECT_TRUE(matchGlob("**/y.md", "y.md"));
+    EXPECT_TRUE(matchGlob("docs/?.txt", "docs/x.txt"));
+    EXPECT_TRUE(matchPathPattern("docs", "docs/sub/y.md"));
+    EXPECT_FALSE(matchPathPattern("doc", "docs/sub/y.md"));
+
+    const std::string testDir = "test_selective_dir";
+    const std::string packDestDir = "test_selective_pack_dest";
+    const std::string unpackDestDir = "test_selective_unpack_dest";
+    CleanupTestDir(testDir);
+    CleanupTestDir(packDestDir);
+    std::filesystem::create_directories(testDir + "/docs/sub");
+
+    std::vector<std::string> files = {testDir + "/docs", testDir + "/docs/sub"};
+    for (const std::string name : {"a.txt", "b.bin", "docs/x.txt", "docs/sub/y.md"}) {
+        ASSERT_TRUE(CreateTestFile(testDir + "/" + name, "content of " + name));
+        files.push_back(testDir + "/" + name);
+    }
+    myPack packer;
+    std::string packedFilePath = packer.pack(files, packDestDir);
+    ASSERT_FALSE(packedFilePath.empty());
+
+    auto restored = [&](const std::vector<std::string>& patterns) {
+        std::filesystem::remove_all(unpackDestDir);
+        std::filesystem::create_directories(unpackDestDir);
+        EXPECT_TRUE(packer.unpack(packedFilePath, unpackDestDir, patterns));
+        std::vector<std::string> result;
+        for (const auto& item : std::filesystem::recursive_directory_iterator(unpackDestDir)) {
+            if (item.is_regular_file()) {
+                result.push_back(item.path().lexically_relative(unpackDestDir).generic_string());
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    // 目录连同其下全部内容
+    EXPECT_EQ(restored({"docs"}), (std::vector<std::string>{"docs/sub/y.md", "docs/x.txt"}));
+    // * 不跨越目录
+    EXPECT_EQ(restored({"*.txt"}), (std::vector<std::string>{"a.txt"}));
+    // ** 跨越多级目录，多个模式取并集
+    EXPECT_EQ(restored({"**/*.md", "./b.bin"}), (std::vector<std::string>{"b.bin", "docs/sub/y.md"}));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/docs/sub/y.md", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "content of docs/sub/y.md");
+
+    // 没有匹配项时失败
+    EXPECT_FALSE(packer.unpack(packedFilePath, unpackDestDir, {"missing/*"}));
+
+    std::filesystem::remove_all(testDir);
+    std::filesystem::remove_all(packDestDir);
+    std::filesystem::remove_all(unpackDestDir);
+}